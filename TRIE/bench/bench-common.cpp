@@ -0,0 +1,96 @@
+#include "bench-common.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <random>
+
+namespace {
+    std::atomic<std::size_t> live_bytes{0};
+    std::atomic<std::size_t> allocations{0};
+
+    //! Velikost alokace se ukládá před vrácený blok, aby ji znal i operator delete bez velikosti.
+    const std::size_t header_size = alignof(std::max_align_t);
+
+    const char *const syllables[] = {
+            "a", "e", "i", "o", "u", "ka", "to", "ne", "re", "sta", "pro", "ment", "tion", "ing", "er",
+            "con", "de", "ex", "in", "ly", "ous", "pre", "sub", "tra", "ver", "al", "an", "or", "ist", "ab",
+    };
+    const char *const sections[] = {"docs", "api", "static", "images", "blog", "user", "search", "item"};
+}
+
+void *operator new(std::size_t size) {
+    void *block = std::malloc(size + header_size);
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    *static_cast<std::size_t *>(block) = size;
+    live_bytes += size;
+    ++allocations;
+    return static_cast<char *>(block) + header_size;
+}
+
+void operator delete(void *ptr) noexcept {
+    if (!ptr) {
+        return;
+    }
+    void *block = static_cast<char *>(ptr) - header_size;
+    live_bytes -= *static_cast<std::size_t *>(block);
+    std::free(block);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    operator delete(ptr);
+}
+
+void *operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete[](void *ptr) noexcept {
+    operator delete(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept {
+    operator delete(ptr);
+}
+
+std::size_t allocated_bytes() {
+    return live_bytes;
+}
+
+std::size_t allocation_count() {
+    return allocations;
+}
+
+std::vector<std::string> generate_words(std::size_t count, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<std::size_t> length(1, 5);
+    std::uniform_int_distribution<std::size_t> syllable(0, sizeof(syllables) / sizeof(syllables[0]) - 1);
+    std::vector<std::string> words;
+    words.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        std::string word;
+        for (std::size_t j = length(gen); j > 0; --j) {
+            word += syllables[syllable(gen)];
+        }
+        words.push_back(std::move(word));
+    }
+    return words;
+}
+
+std::vector<std::string> generate_paths(std::size_t count, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<std::size_t> host(0, 49);
+    std::uniform_int_distribution<std::size_t> section(0, sizeof(sections) / sizeof(sections[0]) - 1);
+    std::uniform_int_distribution<std::size_t> id(0, 9'999'999);
+    auto words = generate_words(1000, seed + 1);
+    std::uniform_int_distribution<std::size_t> word(0, words.size() - 1);
+    std::vector<std::string> paths;
+    paths.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        paths.push_back("https://host" + std::to_string(host(gen)) + ".example.com/" + sections[section(gen)] + "/" +
+                        words[word(gen)] + "/" + std::to_string(id(gen)));
+    }
+    return paths;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*
+    Společné věci pro benchmarky trie: deterministické generátory klíčů
+    a počítadlo paměti alokované na haldě (benchmarky nahrazují globální
+    operator new/delete, viz bench-common.cpp).
+*/
+
+using bench_clock = std::chrono::steady_clock;
+
+/**
+ * Slova poskládaná z několika slabik (a-z), takže sdílejí prefixy podobně
+ * jako slova přirozeného jazyka. Stejný seed dá vždy stejná slova.
+ */
+std::vector<std::string> generate_words(std::size_t count, unsigned seed);
+
+/**
+ * Klíče ve tvaru URL, např. "http://host12.example/docs/item/3141", s dlouhými
+ * společnými prefixy a řetězci uzlů s jediným potomkem.
+ */
+std::vector<std::string> generate_paths(std::size_t count, unsigned seed);
+
+//! Počet bajtů, které jsou právě alokované přes operator new.
+std::size_t allocated_bytes();
+
+//! Počet volání operator new od startu programu.
+std::size_t allocation_count();
+
+//! Změří dobu běhu `fn` v sekundách.
+template <typename Fn>
+double measure(Fn fn) {
+    auto start = bench_clock::now();
+    fn();
+    std::chrono::duration<double> elapsed = bench_clock::now() - start;
+    return elapsed.count();
+}
@@ -0,0 +1,66 @@
+#include "bench-common.hpp"
+#include "../trie.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+    Souběžné čtení jedné trie z více vláken: každé vlákno hledá stejný
+    počet klíčů (polovina v trii je, polovina ne) a občas projde iterátorem
+    kus trie. Propustnost by měla růst s počtem jader, protože čtení nemá
+    žádný sdílený zapisovaný stav.
+*/
+
+namespace {
+    //! Práce jednoho vlákna; vrací počet nalezených klíčů, aby ji překladač nevyhodil.
+    std::size_t read(const trie &t, const std::vector<std::string> &keys, std::size_t first, std::size_t lookups) {
+        std::size_t found = 0;
+        for (std::size_t i = 0; i < lookups; ++i) {
+            const auto &key = keys[(first + i * 7919) % keys.size()];
+            found += t.contains(key);
+            if (i % 4096 == 0) {
+                auto it = t.begin();
+                for (int j = 0; j < 64 && it != t.end(); ++j, ++it) {
+                    found += it.key().size();
+                }
+            }
+        }
+        return found;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    std::size_t count = argc > 1 ? std::stoul(argv[1]) : 200'000;
+    auto keys = generate_words(count, 1);
+    trie t(keys);
+    for (std::size_t i = 0; i < count; i += 2) {
+        keys[i] += '~';
+    }
+    const std::size_t lookups = 1'000'000;
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    std::printf("%zu keys, %zu lookups per thread, %u hardware threads\n", t.size(), lookups, cores);
+
+    double single = 0;
+    for (unsigned threads = 1; threads <= std::max(4u, cores); threads *= 2) {
+        std::vector<std::size_t> found(threads);
+        double elapsed = measure([&]() {
+            std::vector<std::thread> workers;
+            for (unsigned i = 0; i < threads; ++i) {
+                workers.emplace_back([&, i]() { found[i] = read(t, keys, i * 104729, lookups); });
+            }
+            for (auto &worker : workers) {
+                worker.join();
+            }
+        });
+        double rate = threads * lookups / elapsed;
+        if (threads == 1) {
+            single = rate;
+        }
+        std::printf("  %2u threads %10.2f M lookups/s %6.2fx%s\n", threads, rate / 1e6, rate / single,
+                    threads > cores ? " (more threads than cores)" : "");
+    }
+    return 0;
+}
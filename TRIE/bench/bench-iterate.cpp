@@ -0,0 +1,41 @@
+#include "bench-common.hpp"
+#include "../trie.hpp"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/*
+    Průchod celou trií iterátorem: přes key() bez kopírování a přes
+    operator*, který klíč kopíruje. Doba na znak klíče by neměla růst
+    s délkou klíčů (cesty jsou zhruba 6x delší než slova).
+*/
+
+namespace {
+    void run_dataset(const char *name, const std::vector<std::string> &keys) {
+        trie t(keys);
+        std::size_t chars = 0;
+        double by_key = measure([&]() {
+            for (auto it = t.begin(); it != t.end(); ++it) {
+                chars += it.key().size();
+            }
+        });
+        std::size_t copied = 0;
+        double by_value = measure([&]() {
+            for (auto it = t.begin(); it != t.end(); ++it) {
+                copied += (*it).size();
+            }
+        });
+        std::printf("%s (%zu keys, %zu chars)\n", name, t.size(), chars);
+        std::printf("  key()      %8.3f ms %8.2f ns/char\n", by_key * 1e3, by_key / chars * 1e9);
+        std::printf("  operator*  %8.3f ms %8.2f ns/char (%zu chars)\n", by_value * 1e3, by_value / copied * 1e9,
+                    copied);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    std::size_t count = argc > 1 ? std::stoul(argv[1]) : 200'000;
+    run_dataset("words", generate_words(count, 1));
+    run_dataset("paths", generate_paths(count / 2, 2));
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include "bench-common.hpp"
+#include "../trie.hpp"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/*
+    Dotazy na prefixy: search_by_prefix celý, s limitem (prvních 10 doplnění
+    jako u našeptávače) a get_prefixes, proti původnímu postupu, který vypsal
+    všechna slova trie a filtroval je.
+*/
+
+namespace {
+    std::vector<std::string> filter_by_prefix(const trie &t, const std::string &prefix) {
+        std::vector<std::string> words(t.begin(), t.end());
+        std::vector<std::string> ret;
+        for (const auto &word : words) {
+            if (word.compare(0, prefix.size(), prefix) == 0) {
+                ret.push_back(word);
+            }
+        }
+        return ret;
+    }
+
+    template <typename Query>
+    void run(const char *name, const std::vector<std::string> &queries, Query query) {
+        std::size_t results = 0;
+        double elapsed = measure([&]() {
+            for (const auto &q : queries) {
+                results += query(q).size();
+            }
+        });
+        std::printf("  %-22s %12.2f us/query (%zu results)\n", name, elapsed / queries.size() * 1e6, results);
+    }
+
+    void run_dataset(const char *name, const std::vector<std::string> &keys) {
+        trie t(keys);
+        std::vector<std::string> prefixes;
+        std::vector<std::string> words;
+        for (std::size_t i = 0; i < 200; ++i) {
+            const auto &key = keys[i * (keys.size() / 200)];
+            prefixes.push_back(key.substr(0, key.size() / 2));
+            words.push_back(key + "suffix");
+        }
+        std::printf("%s (%zu keys)\n", name, t.size());
+        run("search_by_prefix", prefixes, [&](const std::string &p) { return t.search_by_prefix(p); });
+        run("search_by_prefix, 10", prefixes, [&](const std::string &p) { return t.search_by_prefix(p, 10); });
+        run("get_prefixes", words, [&](const std::string &w) { return t.get_prefixes(w); });
+        std::vector<std::string> few(prefixes.begin(), prefixes.begin() + 5);
+        run("filter all words", few, [&](const std::string &p) { return filter_by_prefix(t, p); });
+    }
+}
+
+int main(int argc, char *argv[]) {
+    std::size_t count = argc > 1 ? std::stoul(argv[1]) : 200'000;
+    run_dataset("words", generate_words(count, 1));
+    run_dataset("paths", generate_paths(count / 2, 2));
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include "bench-common.hpp"
+#include "../radix_trie.hpp"
+#include "../trie.hpp"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/*
+    Porovnání trie (uzel na znak) a radix_trie (uzel na úsek): paměť na haldě,
+    doba stavby, vyhledávání existujících i chybějících klíčů a výpis všech
+    slov pod prefixem. Rozdíl je největší u klíčů ve tvaru URL s dlouhými
+    řetězci uzlů s jediným potomkem.
+*/
+
+namespace {
+    //! Klíče, které v datech nejsou (s pozměněným posledním znakem).
+    std::vector<std::string> make_misses(std::vector<std::string> keys) {
+        for (auto &key : keys) {
+            key.back() = '~';
+            key += '~';
+        }
+        return keys;
+    }
+
+    //! Prefixy prvních klíčů zkrácené na polovinu, pro search_by_prefix.
+    std::vector<std::string> make_prefixes(const std::vector<std::string> &keys, std::size_t count) {
+        std::vector<std::string> prefixes;
+        for (std::size_t i = 0; i < count && i < keys.size(); ++i) {
+            prefixes.push_back(keys[i * (keys.size() / count)].substr(0, keys[i].size() / 2));
+        }
+        return prefixes;
+    }
+
+    template <typename Trie>
+    void run(const char *layout, const std::vector<std::string> &keys, const std::vector<std::string> &misses,
+             const std::vector<std::string> &prefixes) {
+        std::size_t before = allocated_bytes();
+        Trie *t = nullptr;
+        double build = measure([&]() {
+            t = new Trie();
+            for (const auto &key : keys) {
+                t->insert(key);
+            }
+        });
+        std::size_t bytes = allocated_bytes() - before;
+        std::size_t found = 0;
+        double hits = measure([&]() {
+            for (int round = 0; round < 3; ++round) {
+                for (const auto &key : keys) {
+                    found += t->contains(key);
+                }
+            }
+        });
+        double miss = measure([&]() {
+            for (int round = 0; round < 3; ++round) {
+                for (const auto &key : misses) {
+                    found += t->contains(key);
+                }
+            }
+        });
+        std::size_t listed = 0;
+        double prefix = measure([&]() {
+            for (const auto &p : prefixes) {
+                listed += t->search_by_prefix(p).size();
+            }
+        });
+        double destroy = measure([&]() { delete t; });
+        const double lookups = 3.0 * static_cast<double>(keys.size());
+        std::printf("  %-8s %10.1f MB %8.0f B/key %8.3f s build %8.1f ns/hit %8.1f ns/miss "
+                    "%8.1f us/prefix %8.3f s destroy (%zu found, %zu listed)\n",
+                    layout, static_cast<double>(bytes) / (1 << 20), static_cast<double>(bytes) / keys.size(), build,
+                    hits / lookups * 1e9, miss / lookups * 1e9, prefix / prefixes.size() * 1e6, destroy, found,
+                    listed);
+    }
+
+    void run_dataset(const char *name, const std::vector<std::string> &keys) {
+        auto misses = make_misses(keys);
+        auto prefixes = make_prefixes(keys, 1'000);
+        std::size_t length = 0;
+        for (const auto &key : keys) {
+            length += key.size();
+        }
+        radix_trie radix(keys);
+        std::printf("%s (%zu keys, %zu chars, %zu radix nodes)\n", name, keys.size(), length, radix.node_count());
+        run<trie>("trie", keys, misses, prefixes);
+        run<radix_trie>("radix", keys, misses, prefixes);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    std::size_t count = argc > 1 ? std::stoul(argv[1]) : 200'000;
+    run_dataset("words", generate_words(count, 1));
+    run_dataset("paths", generate_paths(count / 2, 2));
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include "bench-common.hpp"
+#include "../trie.hpp"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/*
+    Množinové operace na velkých slovnících: strukturní průchod oběma
+    stromy proti původnímu postupu přes seznamy slov (průnik jako contains
+    pro každé slovo `rhs`, sjednocení jako stavba z obou seznamů).
+    Slovníky se buď z poloviny překrývají, nebo mají různé první znaky.
+*/
+
+namespace {
+    trie naive_intersection(const trie &lhs, const trie &rhs) {
+        std::vector<std::string> words;
+        for (auto it = rhs.begin(); it != rhs.end(); ++it) {
+            if (lhs.contains(it.key())) {
+                words.push_back(it.key());
+            }
+        }
+        return trie(words);
+    }
+
+    trie naive_union(const trie &lhs, const trie &rhs) {
+        std::vector<std::string> words(lhs.begin(), lhs.end());
+        words.insert(words.end(), rhs.begin(), rhs.end());
+        return trie(words);
+    }
+
+    template <typename Operation>
+    void run(const char *name, Operation operation) {
+        std::size_t size = 0;
+        double elapsed = measure([&]() { size = operation(); });
+        std::printf("  %-20s %10.3f ms (%zu words)\n", name, elapsed * 1e3, size);
+    }
+
+    void run_dataset(const char *name, const trie &lhs, const trie &rhs) {
+        std::printf("%s (%zu and %zu words)\n", name, lhs.size(), rhs.size());
+        run("a & b", [&]() { return (lhs & rhs).size(); });
+        run("a & b (word lists)", [&]() { return naive_intersection(lhs, rhs).size(); });
+        run("a | b", [&]() { return (lhs | rhs).size(); });
+        run("a | b (word lists)", [&]() { return naive_union(lhs, rhs).size(); });
+        run("a - b", [&]() { return (lhs - rhs).size(); });
+        // operace na místě vždy na čerstvé kopii `lhs`, kopie se do času nepočítá
+        trie copy(lhs);
+        run("a |= b", [&]() { return (copy |= rhs).size(); });
+        copy = lhs;
+        run("a &= b", [&]() { return (copy &= rhs).size(); });
+        copy = lhs;
+        run("a -= b", [&]() { return (copy -= rhs).size(); });
+    }
+
+    std::vector<std::string> with_prefix(std::vector<std::string> words, const std::string &prefix) {
+        for (auto &word : words) {
+            word.insert(0, prefix);
+        }
+        return words;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    std::size_t count = argc > 1 ? std::stoul(argv[1]) : 200'000;
+    auto words = generate_words(count, 1);
+    auto others = generate_words(count, 2);
+    // polovina slov z `words`, polovina z `others`
+    std::vector<std::string> half(words.begin(), words.begin() + count / 2);
+    half.insert(half.end(), others.begin(), others.begin() + count / 2);
+    run_dataset("words, overlapping", trie(words), trie(half));
+    run_dataset("words, disjoint", trie(with_prefix(words, "a")), trie(with_prefix(others, "z")));
+    auto paths = generate_paths(count / 2, 3);
+    auto other_paths = generate_paths(count / 2, 4);
+    std::vector<std::string> half_paths(paths.begin(), paths.begin() + count / 4);
+    half_paths.insert(half_paths.end(), other_paths.begin(), other_paths.begin() + count / 4);
+    run_dataset("paths, overlapping", trie(paths), trie(half_paths));
+    return 0;
+}
@@ -0,0 +1,146 @@
+#include "bench-common.hpp"
+#include "../trie.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <stack>
+#include <string>
+#include <vector>
+
+/*
+    Porovnání původního uzlu s polem 128 ukazatelů na potomky a kompaktního
+    uzlu (bitmapa + seřazené pole potomků, husté pole jen pro velký počet
+    potomků): paměť na haldě, doba stavby a doba vyhledávání existujících
+    i chybějících klíčů.
+*/
+
+namespace {
+    //! Původní rozložení uzlu, jen pro srovnání.
+    struct array_node {
+        array_node *children[num_chars] = {};
+        array_node *parent = nullptr;
+        char payload = 0;
+        bool is_terminal = false;
+    };
+
+    class array_trie {
+    public:
+        array_trie() : m_root(new array_node()) {}
+
+        ~array_trie() {
+            std::stack<array_node *> nodes;
+            nodes.push(m_root);
+            while (!nodes.empty()) {
+                auto node = nodes.top();
+                nodes.pop();
+                for (auto child : node->children) {
+                    if (child) {
+                        nodes.push(child);
+                    }
+                }
+                delete node;
+            }
+        }
+
+        void insert(const std::string &str) {
+            array_node *node = m_root;
+            for (char c : str) {
+                auto &child = node->children[static_cast<unsigned char>(c)];
+                if (!child) {
+                    child = new array_node();
+                    child->parent = node;
+                    child->payload = c;
+                }
+                node = child;
+            }
+            node->is_terminal = true;
+        }
+
+        bool contains(const std::string &str) const {
+            const array_node *node = m_root;
+            for (char c : str) {
+                node = node->children[static_cast<unsigned char>(c)];
+                if (!node) {
+                    return false;
+                }
+            }
+            return node->is_terminal;
+        }
+
+    private:
+        array_node *m_root;
+    };
+
+    std::vector<std::string> generate_random(std::size_t count, unsigned seed) {
+        std::mt19937 gen(seed);
+        std::uniform_int_distribution<int> chars(33, 126);
+        std::vector<std::string> keys(count);
+        for (auto &key : keys) {
+            for (int i = 0; i < 20; ++i) {
+                key += static_cast<char>(chars(gen));
+            }
+        }
+        return keys;
+    }
+
+    //! Klíče, které v datech nejsou (s pozměněným posledním znakem).
+    std::vector<std::string> make_misses(std::vector<std::string> keys) {
+        for (auto &key : keys) {
+            key.back() = '~';
+            key += '~';
+        }
+        return keys;
+    }
+
+    template <typename Trie>
+    void run(const char *layout, const std::vector<std::string> &keys, const std::vector<std::string> &misses) {
+        std::size_t before = allocated_bytes();
+        std::size_t allocations_before = allocation_count();
+        Trie *t = nullptr;
+        double build = measure([&]() {
+            t = new Trie();
+            for (const auto &key : keys) {
+                t->insert(key);
+            }
+        });
+        std::size_t bytes = allocated_bytes() - before;
+        std::size_t allocations = allocation_count() - allocations_before;
+        std::size_t found = 0;
+        double hits = measure([&]() {
+            for (int round = 0; round < 3; ++round) {
+                for (const auto &key : keys) {
+                    found += t->contains(key);
+                }
+            }
+        });
+        double miss = measure([&]() {
+            for (int round = 0; round < 3; ++round) {
+                for (const auto &key : misses) {
+                    found += t->contains(key);
+                }
+            }
+        });
+        double destroy = measure([&]() { delete t; });
+        const double lookups = 3.0 * static_cast<double>(keys.size());
+        std::printf("  %-8s %10.1f MB %8.0f B/key %9zu allocs %8.3f s build %8.1f ns/hit %8.1f ns/miss "
+                    "%8.3f s destroy (%zu found)\n",
+                    layout, static_cast<double>(bytes) / (1 << 20), static_cast<double>(bytes) / keys.size(),
+                    allocations, build, hits / lookups * 1e9, miss / lookups * 1e9, destroy, found);
+    }
+
+    void run_dataset(const char *name, const std::vector<std::string> &keys) {
+        auto misses = make_misses(keys);
+        std::printf("%s (%zu keys)\n", name, keys.size());
+        run<array_trie>("array", keys, misses);
+        run<trie>("compact", keys, misses);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    std::size_t count = argc > 1 ? std::stoul(argv[1]) : 200'000;
+    run_dataset("words", generate_words(count, 1));
+    run_dataset("paths", generate_paths(count / 2, 2));
+    run_dataset("random", generate_random(count / 4, 3));
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include "bench-common.hpp"
+#include "../trie.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/*
+    Cena přesunu a kopie trie: vektor trií, který se při růstu realokuje
+    (prvky se přesouvají), přesun jedné velké trie a kopie velké trie
+    strukturou uzlů proti kopii přes seznam slov (jak se kopírovalo dřív).
+*/
+
+namespace {
+    //! Kopie přes slova: vypsat všechna slova a vložit je do nové trie.
+    trie copy_by_words(const trie &source) {
+        std::vector<std::string> words(source.begin(), source.end());
+        return trie(words);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    std::size_t count = argc > 1 ? std::stoul(argv[1]) : 200'000;
+    auto words = generate_words(count, 1);
+
+    {
+        // hodně malých trií; push_back bez reserve vektor několikrát realokuje
+        // při malém počtu slov méně trií, aby se nečetlo za konec vektoru
+        const std::size_t words_per_trie = 100;
+        const std::size_t tries = std::min<std::size_t>(2'000, words.size() / words_per_trie);
+        std::vector<trie> pieces;
+        for (std::size_t i = 0; i < tries; ++i) {
+            pieces.emplace_back(std::vector<std::string>(words.begin() + i * words_per_trie,
+                                                         words.begin() + (i + 1) * words_per_trie));
+        }
+        std::size_t allocations_before = allocation_count();
+        std::vector<trie> grown;
+        double push = measure([&]() {
+            for (auto &piece : pieces) {
+                grown.push_back(std::move(piece));
+            }
+        });
+        std::printf("vector<trie> push_back of %zu tries (%zu words each): %8.3f ms, %zu allocations\n", tries,
+                    words_per_trie, push * 1e3, allocation_count() - allocations_before);
+    }
+
+    trie big(words);
+    std::printf("one trie with %zu words\n", big.size());
+    double move = measure([&]() {
+        trie moved(std::move(big));
+        big = std::move(moved);
+    });
+    std::printf("  move there and back   %12.3f us\n", move * 1e6);
+
+    std::size_t before = allocated_bytes();
+    std::size_t found = 0;
+    double structural = measure([&]() {
+        trie copy(big);
+        found += copy.size();
+    });
+    double by_words = measure([&]() {
+        trie copy = copy_by_words(big);
+        found += copy.size();
+    });
+    std::printf("  copy by structure     %12.3f ms\n", structural * 1e3);
+    std::printf("  copy by words         %12.3f ms\n", by_words * 1e3);
+    std::printf("  (%zu words copied, %zd bytes left)\n", found,
+                static_cast<std::ptrdiff_t>(allocated_bytes() - before));
+    return 0;
+}
@@ -0,0 +1,365 @@
+#include "radix_trie.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <utility>
+
+namespace {
+    //! Pozice potomka začínajícího znakem `c`, nebo místo, kam by patřil.
+    size_t lower_child(const radix_node *node, char c) {
+        auto it = std::lower_bound(node->edges.begin(), node->edges.end(), c, [](char edge, char key) {
+            return static_cast<unsigned char>(edge) < static_cast<unsigned char>(key);
+        });
+        return static_cast<size_t>(it - node->edges.begin());
+    }
+
+    //! Potomek, jehož úsek začíná znakem `c`, nebo nullptr.
+    radix_node *find_child(const radix_node *node, char c) {
+        size_t index = lower_child(node, c);
+        if (index < node->edges.size() && node->edges[index] == c) {
+            return node->children[index];
+        }
+        return nullptr;
+    }
+
+    //! Vloží `child` mezi potomky uzlu `node` na pozici `index`.
+    void insert_child(radix_node *node, size_t index, radix_node *child) {
+        node->edges.insert(node->edges.begin() + index, child->label[0]);
+        node->children.insert(node->children.begin() + index, child);
+    }
+
+    //! Délka společného prefixu `label` a `str` od pozice `pos`.
+    size_t common_prefix(const std::string &label, const std::string &str, size_t pos) {
+        size_t length = std::min(label.size(), str.size() - pos);
+        size_t i = 0;
+        while (i < length && label[i] == str[pos + i]) {
+            ++i;
+        }
+        return i;
+    }
+
+    //! Slije uzel s jeho jediným potomkem.
+    void merge_with_child(radix_node *node) {
+        radix_node *child = node->children.front();
+        node->label += child->label;
+        node->edges = std::move(child->edges);
+        node->children = std::move(child->children);
+        node->is_terminal = child->is_terminal;
+        delete child;
+    }
+
+    radix_node *clone(const radix_node *source) {
+        // kopie bez rekurze: dvojice (zdroj, kopie), jejichž potomky je třeba zkopírovat
+        auto root = new radix_node{source->label, source->edges, {}, source->is_terminal};
+        std::vector<std::pair<const radix_node *, radix_node *>> pending{{source, root}};
+        while (!pending.empty()) {
+            auto item = pending.back();
+            pending.pop_back();
+            item.second->children.reserve(item.first->children.size());
+            for (auto child : item.first->children) {
+                auto copy = new radix_node{child->label, child->edges, {}, child->is_terminal};
+                item.second->children.push_back(copy);
+                pending.emplace_back(child, copy);
+            }
+        }
+        return root;
+    }
+}
+
+radix_trie::radix_trie() : m_root(new radix_node()) {
+}
+
+radix_trie::radix_trie(const std::vector<std::string> &strings) : radix_trie() {
+    for (const auto &word : strings) {
+        insert(word);
+    }
+}
+
+radix_trie::radix_trie(const radix_trie &rhs)
+        : m_root(rhs.m_root ? clone(rhs.m_root) : new radix_node()), m_size(rhs.m_size) {
+}
+
+radix_trie &radix_trie::operator=(const radix_trie &rhs) {
+    if (this != &rhs) {
+        radix_trie copy(rhs);
+        swap(copy);
+    }
+    return *this;
+}
+
+radix_trie::radix_trie(radix_trie &&rhs) noexcept : m_root(rhs.m_root), m_size(rhs.m_size) {
+    rhs.m_root = nullptr;
+    rhs.m_size = 0;
+}
+
+radix_trie &radix_trie::operator=(radix_trie &&rhs) noexcept {
+    if (this != &rhs) {
+        destroy(m_root);
+        m_root = rhs.m_root;
+        m_size = rhs.m_size;
+        rhs.m_root = nullptr;
+        rhs.m_size = 0;
+    }
+    return *this;
+}
+
+radix_trie::~radix_trie() {
+    destroy(m_root);
+}
+
+void radix_trie::destroy(radix_node *root) {
+    if (!root) {
+        return;
+    }
+    std::vector<radix_node *> nodes{root};
+    while (!nodes.empty()) {
+        auto node = nodes.back();
+        nodes.pop_back();
+        nodes.insert(nodes.end(), node->children.begin(), node->children.end());
+        delete node;
+    }
+}
+
+bool radix_trie::insert(const std::string &str) {
+    if (!m_root) {
+        // po přesunu
+        m_root = new radix_node();
+    }
+    radix_node *node = m_root;
+    size_t pos = 0;
+    while (pos < str.size()) {
+        size_t index = lower_child(node, str[pos]);
+        if (index == node->edges.size() || node->edges[index] != str[pos]) {
+            insert_child(node, index, new radix_node{str.substr(pos), {}, {}, true});
+            ++m_size;
+            return true;
+        }
+        radix_node *child = node->children[index];
+        size_t common = common_prefix(child->label, str, pos);
+        if (common < child->label.size()) {
+            // slovo končí nebo se odbočuje uprostřed úseku: úsek rozdělíme
+            auto middle = new radix_node{child->label.substr(0, common), {}, {}, false};
+            child->label.erase(0, common);
+            insert_child(middle, 0, child);
+            node->children[index] = middle;
+            if (pos + common == str.size()) {
+                middle->is_terminal = true;
+            } else {
+                auto leaf = new radix_node{str.substr(pos + common), {}, {}, true};
+                insert_child(middle, lower_child(middle, leaf->label[0]), leaf);
+            }
+            ++m_size;
+            return true;
+        }
+        node = child;
+        pos += common;
+    }
+    if (node->is_terminal) {
+        return false;
+    }
+    node->is_terminal = true;
+    ++m_size;
+    return true;
+}
+
+const radix_node *radix_trie::find(const std::string &str) const {
+    const radix_node *node = m_root;
+    size_t pos = 0;
+    while (node && pos < str.size()) {
+        node = find_child(node, str[pos]);
+        if (!node || str.compare(pos, node->label.size(), node->label) != 0) {
+            return nullptr;
+        }
+        pos += node->label.size();
+    }
+    return node;
+}
+
+bool radix_trie::contains(const std::string &str) const {
+    auto node = find(str);
+    return node && node->is_terminal;
+}
+
+bool radix_trie::erase(const std::string &str) {
+    if (!m_root) {
+        return false;
+    }
+    // cesta od kořene: rodič a index potomka na každé úrovni
+    std::vector<std::pair<radix_node *, size_t>> path;
+    radix_node *node = m_root;
+    size_t pos = 0;
+    while (pos < str.size()) {
+        size_t index = lower_child(node, str[pos]);
+        if (index == node->edges.size() || node->edges[index] != str[pos]) {
+            return false;
+        }
+        radix_node *child = node->children[index];
+        if (str.compare(pos, child->label.size(), child->label) != 0) {
+            return false;
+        }
+        path.emplace_back(node, index);
+        node = child;
+        pos += child->label.size();
+    }
+    if (!node->is_terminal) {
+        return false;
+    }
+    node->is_terminal = false;
+    --m_size;
+    if (path.empty()) {
+        return true;
+    }
+    radix_node *parent = path.back().first;
+    if (node->children.empty()) {
+        parent->edges.erase(path.back().second, 1);
+        parent->children.erase(parent->children.begin() + path.back().second);
+        delete node;
+        // rodič mohl zůstat jen průchozí s jediným potomkem
+        if (parent != m_root && !parent->is_terminal && parent->children.size() == 1) {
+            merge_with_child(parent);
+        }
+    } else if (node->children.size() == 1) {
+        merge_with_child(node);
+    }
+    return true;
+}
+
+size_t radix_trie::size() const {
+    return m_size;
+}
+
+bool radix_trie::empty() const {
+    return m_size == 0;
+}
+
+size_t radix_trie::node_count() const {
+    size_t count = 0;
+    std::vector<const radix_node *> nodes;
+    if (m_root) {
+        nodes.push_back(m_root);
+    }
+    while (!nodes.empty()) {
+        auto node = nodes.back();
+        nodes.pop_back();
+        ++count;
+        nodes.insert(nodes.end(), node->children.begin(), node->children.end());
+    }
+    return count;
+}
+
+std::vector<std::string> radix_trie::search_by_prefix(const std::string &prefix) const {
+    std::vector<std::string> ret;
+    if (!m_root) {
+        return ret;
+    }
+    // sestupujeme k uzlu, jehož úsek prefix pokrývá; prefix může skončit i uprostřed úseku
+    const radix_node *node = m_root;
+    size_t pos = 0; //!< délka klíče až po konec úseku uzlu `node`
+    while (pos < prefix.size()) {
+        const radix_node *child = find_child(node, prefix[pos]);
+        if (!child) {
+            return ret;
+        }
+        size_t common = common_prefix(child->label, prefix, pos);
+        if (common < child->label.size() && pos + common < prefix.size()) {
+            return ret;
+        }
+        node = child;
+        pos += child->label.size();
+    }
+    for (const_iterator it(node, prefix.substr(0, pos - node->label.size())); it != end(); ++it) {
+        ret.push_back(it.key());
+    }
+    return ret;
+}
+
+radix_trie::const_iterator radix_trie::begin() const {
+    if (!m_root || m_size == 0) {
+        return end();
+    }
+    return const_iterator(m_root, std::string());
+}
+
+radix_trie::const_iterator radix_trie::end() const {
+    return const_iterator();
+}
+
+void radix_trie::swap(radix_trie &rhs) {
+    std::swap(m_root, rhs.m_root);
+    std::swap(m_size, rhs.m_size);
+}
+
+bool radix_trie::operator==(const radix_trie &rhs) const {
+    return m_size == rhs.m_size && std::equal(begin(), end(), rhs.begin());
+}
+
+bool radix_trie::operator!=(const radix_trie &rhs) const {
+    return !(*this == rhs);
+}
+
+radix_trie::const_iterator::const_iterator(const radix_node *node, std::string prefix) : m_key(std::move(prefix)) {
+    m_key += node->label;
+    m_stack.push_back({node, 0, m_key.size()});
+    if (!node->is_terminal) {
+        advance();
+    }
+}
+
+void radix_trie::const_iterator::advance() {
+    while (!m_stack.empty()) {
+        frame &top = m_stack.back();
+        if (top.next_child == top.node->children.size()) {
+            m_stack.pop_back();
+            continue;
+        }
+        const radix_node *child = top.node->children[top.next_child++];
+        m_key.resize(top.key_length);
+        m_key += child->label;
+        m_stack.push_back({child, 0, m_key.size()});
+        if (child->is_terminal) {
+            return;
+        }
+    }
+    m_key.clear();
+}
+
+radix_trie::const_iterator &radix_trie::const_iterator::operator++() {
+    advance();
+    return *this;
+}
+
+radix_trie::const_iterator radix_trie::const_iterator::operator++(int) {
+    auto tmp = *this;
+    advance();
+    return tmp;
+}
+
+radix_trie::const_iterator::reference radix_trie::const_iterator::operator*() const {
+    return m_key;
+}
+
+const std::string &radix_trie::const_iterator::key() const {
+    return m_key;
+}
+
+bool radix_trie::const_iterator::operator==(const const_iterator &rhs) const {
+    if (m_stack.empty() || rhs.m_stack.empty()) {
+        return m_stack.empty() == rhs.m_stack.empty();
+    }
+    return m_stack.back().node == rhs.m_stack.back().node;
+}
+
+bool radix_trie::const_iterator::operator!=(const const_iterator &rhs) const {
+    return !(*this == rhs);
+}
+
+void swap(radix_trie &lhs, radix_trie &rhs) {
+    lhs.swap(rhs);
+}
+
+std::ostream &operator<<(std::ostream &out, radix_trie const &trie) {
+    for (auto it = trie.begin(); it != trie.end(); ++it) {
+        out << it.key() << std::endl;
+    }
+    return out;
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <iterator>
+#include <iosfwd>
+
+/**
+ * Uzel radix trie: hrana z předka nese celý úsek řetězce, ne jeden znak.
+ *
+ * Řetězec uzlů s jediným potomkem, jaký v obyčejné trii vznikne z dlouhého
+ * slova, je tu jediný uzel s delším `label`.
+ */
+struct radix_node {
+    std::string label;                 //!< úsek řetězce na hraně od předka (u kořene prázdný)
+    std::string edges;                 //!< první znaky úseků potomků, ve stejném pořadí jako `children`
+    std::vector<radix_node *> children; //!< potomci seřazení podle prvního znaku `label`
+    bool is_terminal = false;          //!< označuje, jestli v tomto uzlu končí slovo
+};
+
+/**
+ * Trie s komprimovanými cestami (radix trie, PATRICIA).
+ *
+ * Má stejné rozhraní jako trie pro vkládání, mazání, vyhledávání a iteraci,
+ * ale každý uzel s jediným potomkem (kromě konců slov) se slévá s potomkem.
+ * Uzlů je tak nejvýše dvakrát víc než slov a hloubka vyhledávání je počet
+ * větvení na cestě, ne délka slova, což se vyplatí hlavně u dlouhých klíčů
+ * se společnými prefixy (URL, cesty k souborům).
+ */
+class radix_trie {
+public:
+    /**
+     * Iterátor přes slova v lexikografickém pořadí.
+     *
+     * Drží si zásobník rozpracovaných uzlů a klíč aktuálního slova, takže
+     * průchod celou trií je lineární v součtu délek úseků.
+     */
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string;
+        using reference = std::string;
+        using pointer = std::string;
+        using difference_type = std::ptrdiff_t;
+
+        const_iterator() = default;
+
+        const_iterator &operator++();
+
+        const_iterator operator++(int);
+
+        reference operator*() const;
+
+        //! Klíč aktuálního slova bez kopírování; platí do dalšího posunu iterátoru.
+        const std::string &key() const;
+
+        bool operator==(const const_iterator &rhs) const;
+
+        bool operator!=(const const_iterator &rhs) const;
+
+    private:
+        friend class radix_trie;
+
+        struct frame {
+            const radix_node *node;
+            size_t next_child;  //!< kterého potomka navštívit příště
+            size_t key_length;  //!< délka klíče včetně úseku tohoto uzlu
+        };
+
+        //! Iterátor na první slovo v podstromu `node`, jehož klíč začíná `prefix`.
+        const_iterator(const radix_node *node, std::string prefix);
+
+        //! Posune se na další uzel, kde končí slovo.
+        void advance();
+
+        std::vector<frame> m_stack;
+        std::string m_key;
+    };
+
+    radix_trie();
+
+    explicit radix_trie(const std::vector<std::string> &strings);
+
+    radix_trie(const radix_trie &rhs);
+
+    radix_trie &operator=(const radix_trie &rhs);
+
+    radix_trie(radix_trie &&rhs) noexcept;
+
+    radix_trie &operator=(radix_trie &&rhs) noexcept;
+
+    ~radix_trie();
+
+    /**
+     * Odstraní daný řetězec z trie.
+     * Vrátí true, pokud byl řetězec odstraněn (byl předtím v trii), jinak false.
+     */
+    bool erase(const std::string &str);
+
+    /**
+     * Vloží řetězec do trie.
+     * Vrátí true, pokud byl řetězec vložen (nebyl předtím v trii), jinak false.
+     */
+    bool insert(const std::string &str);
+
+    /**
+     * Vrátí true, pokud je řetězec v trii, jinak false.
+     */
+    bool contains(const std::string &str) const;
+
+    /**
+     * Vrátí počet unikátních řetězců v trii.
+     */
+    size_t size() const;
+
+    /**
+     * Vrací `true` pokud v trii nejsou žádné prvky.
+     */
+    bool empty() const;
+
+    //! Vrátí počet uzlů včetně kořene (pro měření paměti a hloubky).
+    size_t node_count() const;
+
+    /**
+     * Vrátí všechny prvky trie, které začínají daným prefixem (inkluzivně),
+     * v lexikografickém pořadí. Prochází jen podstrom pod prefixem.
+     */
+    std::vector<std::string> search_by_prefix(const std::string &prefix) const;
+
+    const_iterator begin() const;
+
+    const_iterator end() const;
+
+    /**
+     * Prohodí všechny prvky mezi touto trií a `rhs`.
+     *
+     * Složitost: O(1)
+     */
+    void swap(radix_trie &rhs);
+
+    //! Dvě trie si jsou rovny, pokud obsahují stejné prvky.
+    bool operator==(const radix_trie &rhs) const;
+
+    bool operator!=(const radix_trie &rhs) const;
+
+private:
+    //! Uvolní uzel `root` i celý jeho podstrom (bez rekurze).
+    static void destroy(radix_node *root);
+
+    //! Najde uzel, ve kterém končí `str`, nebo nullptr.
+    const radix_node *find(const std::string &str) const;
+
+    //! ukazatel na kořenový uzel stromu
+    radix_node *m_root;
+
+    //! počet unikátních slov, které trie obsahuje
+    size_t m_size = 0;
+};
+
+void swap(radix_trie &lhs, radix_trie &rhs);
+
+std::ostream &operator<<(std::ostream &out, radix_trie const &trie);
@@ -12,7 +12,7 @@
       * const_iterator()
       * operátory prefix ++, postfix ++
       * operátory ==, !=
-      * operátor *
+      * operátor *, key()
 
     Testy v tomto kroku předpokládají, že metody testované v minulém
     kroku fungují správně, a tudíž se na nich mohou stavět testy pro další
@@ -122,3 +122,36 @@ TEST_CASE("Iterator", "[stage2]") {
         REQUIRE(*it == "a");
     }
 }
+
+TEST_CASE("Iterator key", "[stage2]") {
+    trie t({ "", "a", "ab", "abc", "abd", "b", "ba", "zzz" });
+    SECTION("Key follows the iteration") {
+        std::vector<std::string> keys;
+        for (auto it = t.begin(); it != t.end(); ++it) {
+            REQUIRE(it.key() == *it);
+            keys.push_back(it.key());
+        }
+        REQUIRE(keys == as_vec({ "", "a", "ab", "abc", "abd", "b", "ba", "zzz" }));
+    }
+    SECTION("Copies keep their own key") {
+        auto it = t.begin();
+        ++it;
+        ++it;
+        auto copy = it;
+        ++it;
+        ++it;
+        REQUIRE(copy.key() == "ab");
+        REQUIRE(it.key() == "abd");
+    }
+    SECTION("Iteration after erase and insert") {
+        REQUIRE(t.erase("abc"));
+        REQUIRE(t.erase(""));
+        REQUIRE(t.insert("abca"));
+        REQUIRE(extract_all(t) == as_vec({ "a", "ab", "abca", "abd", "b", "ba", "zzz" }));
+    }
+    SECTION("Long keys") {
+        std::string long_key(10'000, 'x');
+        trie deep({ long_key, long_key + "y", "y" });
+        REQUIRE(extract_all(deep) == as_vec({ long_key, long_key + "y", "y" }));
+    }
+}
@@ -2,14 +2,19 @@
 #include "test-helpers.hpp"
 #include "catch.hpp"
 
+#include <set>
+
 /*
     Testy pro stage-04.
 
     Tento krok testuje
       * search_by_prefix
       * get_prefixes
+      * for_each_with_prefix, for_each_prefix_of a omezení počtu výsledků
       * sjednocení trií (operator|)
       * průnik trií (operator&)
+      * rozdíl trií (operator-)
+      * operátory |=, &=, -=
 
     Testy v tomto kroku předpokládají, že metody testované v minulém
     kroku fungují správně, a tudíž se na nich mohou stavět testy pro další
@@ -39,6 +44,56 @@ TEST_CASE("Get prefixes", "[get_prefixes]") {
     }
 }
 
+TEST_CASE("Prefix queries with a limit", "[search_by_prefix][get_prefixes]") {
+    trie trie;
+    insert_all(trie, { "a", "aa", "aaa", "aabb", "aabab", "aaaab", "aaqqq", "b", "ba" });
+    SECTION("Results are ordered") {
+        REQUIRE(trie.search_by_prefix("aa") == as_vec({ "aa", "aaa", "aaaab", "aabab", "aabb", "aaqqq" }));
+        REQUIRE(trie.get_prefixes("aabab") == as_vec({ "a", "aa", "aabab" }));
+    }
+    SECTION("Limit returns the first results") {
+        REQUIRE(trie.search_by_prefix("aa", 3) == as_vec({ "aa", "aaa", "aaaab" }));
+        REQUIRE(trie.search_by_prefix("aab", 1) == as_vec({ "aabab" }));
+        REQUIRE(trie.search_by_prefix("", 0).empty());
+        REQUIRE(trie.search_by_prefix("b", 10) == as_vec({ "b", "ba" }));
+        REQUIRE(trie.get_prefixes("aaaab", 2) == as_vec({ "a", "aa" }));
+        REQUIRE(trie.get_prefixes("aaaab", 0).empty());
+    }
+    SECTION("Prefix that is not in the trie") {
+        REQUIRE(trie.search_by_prefix("ab").empty());
+        REQUIRE(trie.search_by_prefix("aabba").empty());
+        REQUIRE(trie.get_prefixes("c").empty());
+        REQUIRE(trie.get_prefixes("").empty());
+        trie.insert("");
+        REQUIRE(trie.get_prefixes("") == as_vec({ "" }));
+        REQUIRE(trie.get_prefixes("ba") == as_vec({ "", "b", "ba" }));
+    }
+    SECTION("Results are streamed") {
+        std::vector<std::string> words;
+        auto count = trie.for_each_with_prefix("aa", [&](const std::string &word) { words.push_back(word); }, 4);
+        REQUIRE(count == 4);
+        REQUIRE(words == as_vec({ "aa", "aaa", "aaaab", "aabab" }));
+        words.clear();
+        count = trie.for_each_prefix_of("aaqqqq", [&](const std::string &word) { words.push_back(word); });
+        REQUIRE(count == 3);
+        REQUIRE(words == as_vec({ "a", "aa", "aaqqq" }));
+    }
+    SECTION("Search matches filtering all words") {
+        auto data = generate_data(5'000);
+        insert_all(trie, data);
+        for (size_t i = 0; i < 50; ++i) {
+            auto prefix = data[i].substr(0, i % 4);
+            std::vector<std::string> expected;
+            for (const auto &word : extract_all(trie)) {
+                if (word.compare(0, prefix.size(), prefix) == 0) {
+                    expected.push_back(word);
+                }
+            }
+            VALIDATE_SETS(trie.search_by_prefix(prefix), expected);
+        }
+    }
+}
+
 TEST_CASE("Trie union", "[union]") {
     trie t1, t2;
     SECTION("Empty tries") {
@@ -140,3 +195,117 @@ TEST_CASE("Trie intersection", "[intersection]") {
         REQUIRE(res == trie({ "ddd" }));
     }
 }
+
+TEST_CASE("Trie difference", "[difference]") {
+    trie t1({ "queue", "quiz", "quizzical", "quilt" });
+    SECTION("Empty tries") {
+        trie t2;
+        REQUIRE((t2 - t1).empty());
+        REQUIRE((t1 - t2) == t1);
+    }
+    SECTION("Identical tries") {
+        auto res = t1 - t1;
+        REQUIRE(res.empty());
+        REQUIRE(res.begin() == res.end());
+    }
+    SECTION("Overlapping tries") {
+        trie t2({ "quilt", "queue", "quitter", "quiz" });
+        auto res = t1 - t2;
+        CHECK(res.size() == 1);
+        REQUIRE(res == trie({ "quizzical" }));
+        REQUIRE((t2 - t1) == trie({ "quitter" }));
+    }
+    SECTION("Prefixes are kept") {
+        trie t2({ "quiz", "quizz" });
+        REQUIRE((t1 - t2) == trie({ "queue", "quizzical", "quilt" }));
+        REQUIRE((t2 - t1) == trie({ "quizz" }));
+    }
+}
+
+TEST_CASE("In-place set operations", "[union][intersection][difference]") {
+    trie t1({ "", "a", "ab", "abc", "b", "bcd" });
+    trie t2({ "ab", "abcd", "b", "bc", "x" });
+    SECTION("Union") {
+        t1 |= t2;
+        CHECK(t1.size() == 9);
+        REQUIRE(extract_all(t1) == as_vec({ "", "a", "ab", "abc", "abcd", "b", "bc", "bcd", "x" }));
+        REQUIRE(extract_all(t2) == as_vec({ "ab", "abcd", "b", "bc", "x" }));
+        t2.insert("y");
+        REQUIRE_FALSE(t1.contains("y"));
+    }
+    SECTION("Intersection") {
+        t1 &= t2;
+        CHECK(t1.size() == 2);
+        REQUIRE(extract_all(t1) == as_vec({ "ab", "b" }));
+        REQUIRE(t1.insert("abcde"));
+        REQUIRE(t1.erase("ab"));
+        REQUIRE(extract_all(t1) == as_vec({ "abcde", "b" }));
+    }
+    SECTION("Difference") {
+        t1 -= t2;
+        CHECK(t1.size() == 4);
+        REQUIRE(extract_all(t1) == as_vec({ "", "a", "abc", "bcd" }));
+    }
+    SECTION("With itself") {
+        trie copy(t1);
+        t1 |= t1;
+        REQUIRE(t1 == copy);
+        t1 &= t1;
+        REQUIRE(t1 == copy);
+        t1 -= t1;
+        REQUIRE(t1.empty());
+        REQUIRE(t1.insert("a"));
+    }
+    SECTION("With an empty trie") {
+        trie empty;
+        trie copy(t1);
+        t1 |= empty;
+        t1 -= empty;
+        REQUIRE(t1 == copy);
+        t1 &= empty;
+        REQUIRE(t1.empty());
+        empty |= copy;
+        REQUIRE(empty == copy);
+    }
+}
+
+TEST_CASE("Set operations against std::set", "[union][intersection][difference]") {
+    // krátká slova z malé abecedy, aby se trie hodně překrývaly
+    auto words = [](size_t count, unsigned seed) {
+        std::vector<std::string> ret;
+        for (size_t i = 0; i < count; ++i) {
+            std::string word;
+            for (size_t x = (i * 2654435761u + seed) % 100'003; word.size() < 1 + x % 6; x /= 3) {
+                word += static_cast<char>('a' + x % 3);
+            }
+            ret.push_back(word);
+        }
+        return ret;
+    };
+    auto lhs_words = words(3'000, 1);
+    auto rhs_words = words(2'000, 77);
+    std::set<std::string> lhs_set(lhs_words.begin(), lhs_words.end());
+    std::set<std::string> rhs_set(rhs_words.begin(), rhs_words.end());
+    trie lhs(lhs_words);
+    trie rhs(rhs_words);
+
+    std::vector<std::string> expected;
+    std::set_union(lhs_set.begin(), lhs_set.end(), rhs_set.begin(), rhs_set.end(), std::back_inserter(expected));
+    REQUIRE(extract_all(lhs | rhs) == expected);
+    REQUIRE((lhs | rhs).size() == expected.size());
+
+    expected.clear();
+    std::set_intersection(lhs_set.begin(), lhs_set.end(), rhs_set.begin(), rhs_set.end(),
+                          std::back_inserter(expected));
+    REQUIRE(extract_all(lhs & rhs) == expected);
+    REQUIRE((lhs & rhs).size() == expected.size());
+    trie in_place(lhs);
+    in_place &= rhs;
+    REQUIRE(extract_all(in_place) == expected);
+    REQUIRE(in_place.size() == expected.size());
+
+    expected.clear();
+    std::set_difference(lhs_set.begin(), lhs_set.end(), rhs_set.begin(), rhs_set.end(), std::back_inserter(expected));
+    REQUIRE(extract_all(lhs - rhs) == expected);
+    REQUIRE((lhs - rhs).size() == expected.size());
+}
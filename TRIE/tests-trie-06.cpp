@@ -0,0 +1,296 @@
+#include "test-helpers.hpp"
+#include "trie.hpp"
+#include "catch.hpp"
+
+#include <thread>
+#include <type_traits>
+
+/*
+    Testy pro stage-06.
+
+    Tento krok testuje kompaktní uložení potomků v uzlu, tj.
+      * trie_node::child, first_child, next_child
+      * trie_node::add_child, remove_child
+      * přechod na husté pole při velkém počtu potomků
+    a to, že se přes ně chovají insert, contains, erase a iterace trie
+    stejně jako dřív.
+
+    Dále testuje přidělování uzlů z node_arena:
+      * new_node, delete_node, new_children, delete_children
+      * opakované použití uvolněných uzlů a polí
+      * clear
+
+    A nakonec přesuny, které si berou uzly i paměť původní trie, kopie,
+    které kopírují strukturu uzlů, a souběžné čtení z více vláken.
+*/
+
+namespace {
+    //! Jednoznakové řetězce pro všechny tisknutelné znaky ASCII.
+    std::vector<std::string> all_chars(const std::string &prefix) {
+        std::vector<std::string> ret;
+        for (char c = 1; c > 0 && static_cast<size_t>(c) < num_chars; ++c) {
+            ret.push_back(prefix + c);
+        }
+        return ret;
+    }
+}
+
+
+TEST_CASE("Compact node children", "[stage6]") {
+    node_arena arena;
+    trie_node node;
+    std::vector<trie_node> children(3);
+    children[0].payload = 'm';
+    children[1].payload = 'a';
+    children[2].payload = 'z';
+    for (auto &child : children) {
+        node.add_child(arena, &child);
+    }
+    SECTION("Children are found by their character") {
+        REQUIRE(node.child('a') == &children[1]);
+        REQUIRE(node.child('m') == &children[0]);
+        REQUIRE(node.child('z') == &children[2]);
+        REQUIRE(node.child('b') == nullptr);
+        REQUIRE(node.child_count == 3);
+    }
+    SECTION("Children are ordered by their character") {
+        REQUIRE(node.first_child() == &children[1]);
+        REQUIRE(node.next_child('a') == &children[0]);
+        REQUIRE(node.next_child('m') == &children[2]);
+        REQUIRE(node.next_child('z') == nullptr);
+        REQUIRE(node.next_child('b') == &children[0]);
+    }
+    SECTION("Removing a child keeps the others") {
+        node.remove_child(arena, 'm');
+        REQUIRE(node.child('m') == nullptr);
+        REQUIRE(node.child('a') == &children[1]);
+        REQUIRE(node.next_child('a') == &children[2]);
+        node.remove_child(arena, 'a');
+        node.remove_child(arena, 'z');
+        REQUIRE_FALSE(node.has_children());
+        REQUIRE(node.first_child() == nullptr);
+    }
+    SECTION("Small nodes do not use the dense array") {
+        REQUIRE(node.child_capacity < num_chars);
+    }
+}
+
+TEST_CASE("High fan-out nodes", "[stage6]") {
+    auto strings = all_chars("x");
+    trie t(strings);
+    REQUIRE(t.size() == strings.size());
+    SECTION("All children are found") {
+        for (const auto &str : strings) {
+            REQUIRE(t.contains(str));
+        }
+        REQUIRE_FALSE(t.contains("x"));
+        REQUIRE_FALSE(t.contains("xx1"));
+    }
+    SECTION("Iteration is ordered") {
+        REQUIRE(extract_all(t) == strings);
+    }
+    SECTION("Erasing every other child") {
+        std::vector<std::string> kept;
+        for (size_t i = 0; i < strings.size(); ++i) {
+            if (i % 2) {
+                REQUIRE(t.erase(strings[i]));
+            } else {
+                kept.push_back(strings[i]);
+            }
+        }
+        REQUIRE(t.size() == kept.size());
+        REQUIRE(extract_all(t) == kept);
+        for (size_t i = 0; i < strings.size(); ++i) {
+            REQUIRE(t.contains(strings[i]) == (i % 2 == 0));
+        }
+    }
+    SECTION("Erasing everything") {
+        for (const auto &str : strings) {
+            REQUIRE(t.erase(str));
+        }
+        REQUIRE(t.empty());
+        REQUIRE(t.begin() == t.end());
+        REQUIRE(t.insert("x1"));
+        REQUIRE(extract_all(t) == as_vec({"x1"}));
+    }
+}
+
+TEST_CASE("Children inserted out of order", "[stage6]") {
+    trie t;
+    auto strings = all_chars("");
+    // vkládáme od konce i napřeskáčku, aby se pole potomků posouvalo
+    for (size_t i = strings.size(); i-- > 0;) {
+        if (i % 3 == 0) {
+            t.insert(strings[i]);
+        }
+    }
+    for (size_t i = 0; i < strings.size(); ++i) {
+        if (i % 3 != 0) {
+            t.insert(strings[i]);
+        }
+    }
+    REQUIRE(extract_all(t) == strings);
+    VALIDATE_SETS(extract_all(t), strings);
+}
+
+TEST_CASE("Node arena", "[stage6]") {
+    node_arena arena;
+    SECTION("New nodes are empty") {
+        auto node = arena.new_node();
+        REQUIRE(node->first_child() == nullptr);
+        REQUIRE(node->parent == nullptr);
+        REQUIRE_FALSE(node->is_terminal);
+        REQUIRE(arena.slab_count() == 1);
+    }
+    SECTION("Many nodes need only a few slabs") {
+        std::vector<trie_node *> nodes;
+        for (int i = 0; i < 10'000; ++i) {
+            nodes.push_back(arena.new_node());
+        }
+        std::sort(nodes.begin(), nodes.end());
+        REQUIRE(std::unique(nodes.begin(), nodes.end()) == nodes.end());
+        REQUIRE(arena.slab_count() <= 10'000 * sizeof(trie_node) / (64 * 1024) + 1);
+    }
+    SECTION("Deleted nodes are reused") {
+        auto first = arena.new_node();
+        first->is_terminal = true;
+        arena.new_node();
+        arena.delete_node(first);
+        auto reused = arena.new_node();
+        REQUIRE(reused == first);
+        REQUIRE_FALSE(reused->is_terminal);
+    }
+    SECTION("Deleted child arrays are reused by size") {
+        auto small = arena.new_children(4);
+        auto dense = arena.new_children(num_chars);
+        REQUIRE(std::all_of(dense, dense + num_chars, [](trie_node *node) { return node == nullptr; }));
+        dense[5] = reinterpret_cast<trie_node *>(small);
+        arena.delete_children(small, 4);
+        arena.delete_children(dense, num_chars);
+        REQUIRE(arena.new_children(8) != small);
+        REQUIRE(arena.new_children(4) == small);
+        auto dense_again = arena.new_children(num_chars);
+        REQUIRE(dense_again == dense);
+        REQUIRE(dense_again[5] == nullptr);
+    }
+    SECTION("Clear releases all slabs") {
+        for (int i = 0; i < 5'000; ++i) {
+            arena.new_node();
+        }
+        arena.clear();
+        REQUIRE(arena.slab_count() == 0);
+        REQUIRE(arena.new_node() != nullptr);
+        REQUIRE(arena.slab_count() == 1);
+    }
+}
+
+TEST_CASE("Tries keep working over the arena", "[stage6]") {
+    auto strings = generate_data(2'000);
+    trie t(strings);
+    SECTION("Erase and insert again reuse the nodes") {
+        for (size_t i = 0; i < strings.size(); i += 2) {
+            REQUIRE(t.erase(strings[i]));
+        }
+        for (size_t i = 0; i < strings.size(); i += 2) {
+            REQUIRE(t.insert(strings[i]));
+        }
+        VALIDATE_SETS(extract_all(t), strings);
+    }
+    SECTION("Assignment and swap") {
+        trie other({"abc", "abd"});
+        other = t;
+        VALIDATE_SETS(extract_all(other), strings);
+        trie small({"x"});
+        swap(small, other);
+        VALIDATE_SETS(extract_all(small), strings);
+        REQUIRE(extract_all(other) == as_vec({"x"}));
+        other.insert("y");
+        REQUIRE(extract_all(other) == as_vec({"x", "y"}));
+    }
+}
+
+TEST_CASE("Moves steal the nodes", "[stage6]") {
+    static_assert(std::is_nothrow_move_constructible<trie>::value, "vector<trie> must move, not copy");
+    static_assert(std::is_nothrow_move_assignable<trie>::value, "trie move assignment must not throw");
+    auto strings = generate_data(2'000);
+    trie t(strings);
+    SECTION("Move constructor takes all words") {
+        size_t size = t.size();
+        trie moved(std::move(t));
+        REQUIRE(moved.size() == size);
+        VALIDATE_SETS(extract_all(moved), strings);
+    }
+    SECTION("Moved from trie is empty and usable") {
+        trie moved(std::move(t));
+        REQUIRE(t.empty());
+        REQUIRE(t.begin() == t.end());
+        REQUIRE_FALSE(t.contains(""));
+        REQUIRE_FALSE(t.contains(strings[0]));
+        REQUIRE_FALSE(t.erase(""));
+        REQUIRE_FALSE(t.erase(strings[0]));
+        REQUIRE(t.search_by_prefix("").empty());
+        trie copy(t);
+        REQUIRE(copy.empty());
+        copy = t;
+        REQUIRE(copy.empty());
+        REQUIRE(t.insert("abc"));
+        REQUIRE(t.insert(""));
+        REQUIRE(extract_all(t) == as_vec({"", "abc"}));
+    }
+    SECTION("Move assignment releases the old nodes") {
+        trie other({"x", "y"});
+        other = std::move(t);
+        VALIDATE_SETS(extract_all(other), strings);
+        REQUIRE(t.empty());
+        t = std::move(other);
+        VALIDATE_SETS(extract_all(t), strings);
+    }
+    SECTION("Reallocating a vector keeps the tries") {
+        std::vector<trie> tries;
+        for (int i = 0; i < 50; ++i) {
+            tries.push_back(trie({std::to_string(i), "x"}));
+        }
+        for (int i = 0; i < 50; ++i) {
+            REQUIRE(extract_all(tries[i]) == as_vec({std::to_string(i), "x"}));
+        }
+    }
+    SECTION("Copy keeps the structure and is independent") {
+        trie copy(t);
+        REQUIRE(copy.size() == t.size());
+        REQUIRE(extract_all(copy) == extract_all(t));
+        REQUIRE(copy.erase(strings[0]));
+        REQUIRE(copy.insert("zzz"));
+        REQUIRE(t.contains(strings[0]));
+        REQUIRE_FALSE(t.contains("zzz"));
+        REQUIRE(copy.erase("zzz"));
+        REQUIRE(copy.insert(strings[0]));
+        REQUIRE(copy == t);
+    }
+}
+
+TEST_CASE("Concurrent readers", "[stage6]") {
+    auto strings = generate_data(2'000);
+    trie t1(strings);
+    trie t2({"abc", "abd", "b"});
+    const auto all1 = extract_all(t1);
+    const auto all2 = extract_all(t2);
+    std::vector<int> ok(4, 0);
+    std::vector<std::thread> readers;
+    for (size_t i = 0; i < ok.size(); ++i) {
+        readers.emplace_back([&, i]() {
+            // vlákna čtou obě trie najednou, včetně begin() a dotazů na prefixy
+            bool good = true;
+            for (int round = 0; round < 20; ++round) {
+                good = good && extract_all(t1) == all1 && extract_all(t2) == all2;
+                good = good && t1.contains(strings[(i * 31 + round) % strings.size()]) && !t2.contains("ab");
+                good = good && t2.search_by_prefix("ab") == as_vec({"abc", "abd"});
+                good = good && t1.get_prefixes(strings[round]) == as_vec({strings[round]});
+            }
+            ok[i] = good;
+        });
+    }
+    for (auto &reader : readers) {
+        reader.join();
+    }
+    REQUIRE(ok == std::vector<int>(ok.size(), 1));
+}
@@ -0,0 +1,167 @@
+#include "test-helpers.hpp"
+#include "radix_trie.hpp"
+#include "catch.hpp"
+
+#include <random>
+#include <set>
+
+/*
+    Testy pro stage-07.
+
+    Tento krok testuje radix_trie (trii s komprimovanými cestami):
+      * insert, erase, contains, size, empty
+      * rozdělování úseků při vkládání a slévání uzlů při mazání
+      * iteraci v lexikografickém pořadí
+      * search_by_prefix, i pro prefix končící uprostřed úseku
+      * kopírování, přesun a swap
+    a nakonec vše porovná s std::set na náhodných datech.
+*/
+
+namespace {
+    std::vector<std::string> extract_all(const radix_trie &t) {
+        return {t.begin(), t.end()};
+    }
+}
+
+
+TEST_CASE("Radix trie basics", "[stage7]") {
+    radix_trie t;
+    REQUIRE(t.empty());
+    REQUIRE(t.begin() == t.end());
+    REQUIRE(t.insert("romane"));
+    REQUIRE(t.insert("romanus"));
+    REQUIRE(t.insert("romulus"));
+    REQUIRE(t.insert("rubens"));
+    REQUIRE(t.insert("ruber"));
+    REQUIRE(t.insert("rubicon"));
+    REQUIRE(t.insert("rubicundus"));
+    REQUIRE_FALSE(t.insert("ruber"));
+    REQUIRE(t.size() == 7);
+    SECTION("Contains only whole words") {
+        REQUIRE(t.contains("romane"));
+        REQUIRE(t.contains("rubicundus"));
+        REQUIRE_FALSE(t.contains("rom"));
+        REQUIRE_FALSE(t.contains("roman"));
+        REQUIRE_FALSE(t.contains("rubicundusx"));
+        REQUIRE_FALSE(t.contains(""));
+    }
+    SECTION("Iteration is ordered") {
+        REQUIRE(extract_all(t) == as_vec({"romane", "romanus", "romulus", "rubens", "ruber", "rubicon", "rubicundus"}));
+    }
+    SECTION("Paths are compressed") {
+        // kořen, r, om, an, e, us, ulus, ub, e, ns, r, ic, on, undus
+        REQUIRE(t.node_count() == 14);
+    }
+    SECTION("Inserting a prefix of a label splits it") {
+        REQUIRE(t.insert("rom"));
+        REQUIRE(t.contains("rom"));
+        REQUIRE(t.insert("r"));
+        REQUIRE(t.insert(""));
+        REQUIRE(extract_all(t) == as_vec({"", "r", "rom", "romane", "romanus", "romulus", "rubens", "ruber",
+                                          "rubicon", "rubicundus"}));
+    }
+    SECTION("Erase merges single-child nodes back") {
+        size_t nodes = t.node_count();
+        REQUIRE(t.insert("roma"));
+        REQUIRE(t.erase("roma"));
+        REQUIRE(t.node_count() == nodes);
+        REQUIRE(t.erase("romanus"));
+        REQUIRE_FALSE(t.erase("romanus"));
+        REQUIRE_FALSE(t.erase("rub"));
+        REQUIRE(t.contains("romane"));
+        // "an" + "e" se slily do jednoho úseku
+        REQUIRE(t.node_count() == nodes - 2);
+        REQUIRE(extract_all(t) == as_vec({"romane", "romulus", "rubens", "ruber", "rubicon", "rubicundus"}));
+    }
+    SECTION("Erase everything") {
+        for (auto const &word : extract_all(t)) {
+            REQUIRE(t.erase(word));
+        }
+        REQUIRE(t.empty());
+        REQUIRE(t.node_count() == 1);
+        REQUIRE(t.begin() == t.end());
+    }
+}
+
+TEST_CASE("Radix trie prefix search", "[stage7]") {
+    radix_trie t({"https://a.example/docs/1", "https://a.example/docs/2", "https://a.example/api",
+                  "https://b.example/", "ftp://c.example"});
+    REQUIRE(t.search_by_prefix("https://a.example/d") ==
+            as_vec({"https://a.example/docs/1", "https://a.example/docs/2"}));
+    REQUIRE(t.search_by_prefix("https://") ==
+            as_vec({"https://a.example/api", "https://a.example/docs/1", "https://a.example/docs/2",
+                    "https://b.example/"}));
+    REQUIRE(t.search_by_prefix("https://b.example/") == as_vec({"https://b.example/"}));
+    REQUIRE(t.search_by_prefix("https://b.example/x").empty());
+    REQUIRE(t.search_by_prefix("https://c").empty());
+    REQUIRE(t.search_by_prefix("x").empty());
+    REQUIRE(t.search_by_prefix("").size() == 5);
+}
+
+TEST_CASE("Radix trie copy and move", "[stage7]") {
+    radix_trie t({"alpha", "alphabet", "beta"});
+    SECTION("Copy is independent") {
+        radix_trie copy(t);
+        copy.insert("gamma");
+        copy.erase("alpha");
+        REQUIRE(extract_all(t) == as_vec({"alpha", "alphabet", "beta"}));
+        REQUIRE(extract_all(copy) == as_vec({"alphabet", "beta", "gamma"}));
+        copy = t;
+        REQUIRE(copy == t);
+    }
+    SECTION("Moved from trie is empty and usable") {
+        radix_trie moved(std::move(t));
+        REQUIRE(extract_all(moved) == as_vec({"alpha", "alphabet", "beta"}));
+        REQUIRE(t.empty());
+        REQUIRE(t.begin() == t.end());
+        REQUIRE_FALSE(t.contains("alpha"));
+        REQUIRE(t.search_by_prefix("").empty());
+        radix_trie copy(t);
+        REQUIRE(copy.empty());
+        REQUIRE(t.insert("delta"));
+        REQUIRE(extract_all(t) == as_vec({"delta"}));
+        t = std::move(moved);
+        REQUIRE(t.size() == 3);
+    }
+    SECTION("Swap") {
+        radix_trie other({"x"});
+        swap(t, other);
+        REQUIRE(extract_all(t) == as_vec({"x"}));
+        REQUIRE(other.size() == 3);
+    }
+}
+
+TEST_CASE("Radix trie against std::set", "[stage7]") {
+    std::mt19937 gen(7);
+    // málo znaků a krátká slova, aby vznikalo hodně společných prefixů
+    std::uniform_int_distribution<int> letter('a', 'd');
+    std::uniform_int_distribution<int> length(0, 8);
+    std::uniform_int_distribution<int> action(0, 2);
+    radix_trie t;
+    std::set<std::string> reference;
+    for (int i = 0; i < 20'000; ++i) {
+        std::string word;
+        for (int j = length(gen); j > 0; --j) {
+            word += static_cast<char>(letter(gen));
+        }
+        if (action(gen) == 0) {
+            REQUIRE(t.erase(word) == (reference.erase(word) == 1));
+        } else {
+            REQUIRE(t.insert(word) == reference.insert(word).second);
+        }
+        REQUIRE(t.contains(word) == (reference.count(word) == 1));
+    }
+    REQUIRE(t.size() == reference.size());
+    REQUIRE(extract_all(t) == std::vector<std::string>(reference.begin(), reference.end()));
+    for (const std::string prefix : {"", "a", "ab", "abc", "dddd", "cab"}) {
+        std::vector<std::string> expected;
+        for (const auto &word : reference) {
+            if (word.compare(0, prefix.size(), prefix) == 0) {
+                expected.push_back(word);
+            }
+        }
+        REQUIRE(t.search_by_prefix(prefix) == expected);
+    }
+    // uzlů je nejvýše dvakrát víc než slov (+ kořen)
+    REQUIRE(t.node_count() <= 2 * t.size() + 1);
+}
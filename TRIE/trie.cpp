@@ -3,13 +3,297 @@
 #include <utility>
 #include <algorithm>
 #include <cassert>
-#include <stack>
+#include <iterator>
+#include <new>
 #include <set>
 #include <iostream>
+#include <type_traits>
 
-trie_node *currentNodePointer;
 using namespace std;
 
+namespace {
+    size_t char_index(char c) {
+        size_t index = static_cast<unsigned char>(c);
+        assert(index < num_chars);
+        return index;
+    }
+
+    size_t popcount(uint64_t bits) {
+#if defined(__POPCNT__)
+        return static_cast<size_t>(__builtin_popcountll(bits));
+#else
+        // bez instrukce popcnt by builtin volal knihovní funkci, sčítání po bitových skupinách je rychlejší
+        bits = bits - ((bits >> 1) & 0x5555555555555555ull);
+        bits = (bits & 0x3333333333333333ull) + ((bits >> 2) & 0x3333333333333333ull);
+        bits = (bits + (bits >> 4)) & 0x0f0f0f0f0f0f0f0full;
+        return static_cast<size_t>((bits * 0x0101010101010101ull) >> 56);
+#endif
+    }
+
+    size_t lowest_bit(uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<size_t>(__builtin_ctzll(bits));
+#else
+        size_t index = 0;
+        for (; !(bits & 1); bits >>= 1) {
+            ++index;
+        }
+        return index;
+#endif
+    }
+
+    //! Počet nastavených bitů pod indexem `index`, tj. pozice potomka v kompaktním poli.
+    size_t child_rank(const uint64_t (&bits)[2], size_t index) {
+        if (index < 64) {
+            return popcount(bits[0] & ((uint64_t(1) << index) - 1));
+        }
+        return popcount(bits[0]) + popcount(bits[1] & ((uint64_t(1) << (index - 64)) - 1));
+    }
+
+    //! Nejmenší nastavený bit od indexu `from` výš, nebo num_chars.
+    size_t next_bit(const uint64_t (&bits)[2], size_t from) {
+        if (from < 64) {
+            uint64_t low = bits[0] & (~uint64_t(0) << from);
+            if (low) {
+                return lowest_bit(low);
+            }
+            from = 64;
+        }
+        if (from < num_chars) {
+            uint64_t high = bits[1] & (~uint64_t(0) << (from - 64));
+            if (high) {
+                return 64 + lowest_bit(high);
+            }
+        }
+        return num_chars;
+    }
+
+    //! Zavolá `fn(c)` pro všechny znaky s nastaveným bitem v (`low`, `high`), vzestupně.
+    template <typename Fn>
+    void for_each_bit(uint64_t low, uint64_t high, Fn fn) {
+        for (; low; low &= low - 1) {
+            fn(static_cast<char>(lowest_bit(low)));
+        }
+        for (; high; high &= high - 1) {
+            fn(static_cast<char>(64 + lowest_bit(high)));
+        }
+    }
+
+    //! Zavolá `fn(c)` pro znaky, pro které mají potomka oba uzly.
+    template <typename Fn>
+    void for_each_common_child(const trie_node *lhs, const trie_node *rhs, Fn fn) {
+        for_each_bit(lhs->child_bits[0] & rhs->child_bits[0], lhs->child_bits[1] & rhs->child_bits[1], fn);
+    }
+
+    //! Zavolá `fn(c)` pro znaky, pro které má potomka `lhs`, ale ne `rhs`.
+    template <typename Fn>
+    void for_each_missing_child(const trie_node *lhs, const trie_node *rhs, Fn fn) {
+        for_each_bit(lhs->child_bits[0] & ~rhs->child_bits[0], lhs->child_bits[1] & ~rhs->child_bits[1], fn);
+    }
+}
+
+namespace {
+    const size_t slab_size = 64 * 1024;
+
+    // node_arena::clear() uvolní bloky bez volání destruktorů uzlů
+    static_assert(std::is_trivially_destructible<trie_node>::value, "trie_node must be trivially destructible");
+}
+
+node_arena::~node_arena() {
+    clear();
+}
+
+void *node_arena::allocate(size_t bytes) {
+    bytes = (bytes + alignof(trie_node) - 1) / alignof(trie_node) * alignof(trie_node);
+    if (static_cast<size_t>(m_end - m_next) < bytes) {
+        m_slabs.push_back(new char[slab_size]);
+        m_next = m_slabs.back();
+        m_end = m_next + slab_size;
+    }
+    void *block = m_next;
+    m_next += bytes;
+    return block;
+}
+
+size_t node_arena::size_class(size_t capacity) {
+    if (capacity == num_chars) {
+        return size_classes - 1;
+    }
+    assert(capacity >= 2 && capacity <= trie_node::dense_threshold && !(capacity & (capacity - 1)));
+    size_t index = 0;
+    while (capacity > 2) {
+        capacity >>= 1;
+        ++index;
+    }
+    return index;
+}
+
+trie_node *node_arena::new_node() {
+    void *block;
+    if (m_free_nodes) {
+        block = m_free_nodes;
+        m_free_nodes = m_free_nodes->next;
+    } else {
+        block = allocate(sizeof(trie_node));
+    }
+    return new(block) trie_node();
+}
+
+void node_arena::delete_node(trie_node *node) {
+    assert(!node->child_capacity || node->child_capacity == 1);
+    node->~trie_node();
+    m_free_nodes = new(node) free_block{m_free_nodes};
+}
+
+trie_node **node_arena::new_children(size_t capacity) {
+    size_t index = size_class(capacity);
+    void *block;
+    if (m_free_children[index]) {
+        block = m_free_children[index];
+        m_free_children[index] = m_free_children[index]->next;
+    } else {
+        block = allocate(capacity * sizeof(trie_node *));
+    }
+    auto array = static_cast<trie_node **>(block);
+    if (capacity == num_chars) {
+        std::fill(array, array + capacity, nullptr);
+    }
+    return array;
+}
+
+void node_arena::delete_children(trie_node **array, size_t capacity) {
+    size_t index = size_class(capacity);
+    m_free_children[index] = new(array) free_block{m_free_children[index]};
+}
+
+void node_arena::clear() {
+    for (auto slab : m_slabs) {
+        delete[] slab;
+    }
+    m_slabs.clear();
+    m_next = m_end = nullptr;
+    m_free_nodes = nullptr;
+    std::fill(std::begin(m_free_children), std::end(m_free_children), nullptr);
+}
+
+void node_arena::swap(node_arena &rhs) {
+    std::swap(m_slabs, rhs.m_slabs);
+    std::swap(m_next, rhs.m_next);
+    std::swap(m_end, rhs.m_end);
+    std::swap(m_free_nodes, rhs.m_free_nodes);
+    std::swap(m_free_children, rhs.m_free_children);
+}
+
+size_t node_arena::slab_count() const {
+    return m_slabs.size();
+}
+
+trie_node *const *trie_node::slots() const {
+    return child_capacity == 1 ? &children.single : children.array;
+}
+
+trie_node **trie_node::slots() {
+    return child_capacity == 1 ? &children.single : children.array;
+}
+
+trie_node *trie_node::child(char c) const {
+    size_t index = char_index(c);
+    if (!((child_bits[index >> 6] >> (index & 63)) & 1)) {
+        return nullptr;
+    }
+    if (child_capacity == 1) {
+        return children.single;
+    }
+    return children.array[child_capacity == num_chars ? index : child_rank(child_bits, index)];
+}
+
+trie_node *trie_node::first_child() const {
+    if (!child_count) {
+        return nullptr;
+    }
+    return slots()[child_capacity == num_chars ? next_bit(child_bits, 0) : 0];
+}
+
+trie_node *trie_node::next_child(char c) const {
+    size_t index = next_bit(child_bits, char_index(c) + 1);
+    if (index == num_chars) {
+        return nullptr;
+    }
+    return slots()[child_capacity == num_chars ? index : child_rank(child_bits, index)];
+}
+
+bool trie_node::has_children() const {
+    return child_count != 0;
+}
+
+void trie_node::add_child(node_arena &arena, trie_node *node) {
+    size_t index = char_index(node->payload);
+    assert(!child(node->payload));
+    if (child_capacity == 0) {
+        // jediný potomek se drží přímo v uzlu, bez pole
+        child_capacity = 1;
+    } else if (child_capacity != num_chars && child_count == child_capacity) {
+        trie_node **grown;
+        trie_node **old = slots();
+        uint8_t capacity;
+        if (child_count >= dense_threshold) {
+            // husté pole indexované znakem
+            capacity = num_chars;
+            grown = arena.new_children(num_chars);
+            for (size_t i = 0, bit = next_bit(child_bits, 0); i < child_count; ++i, bit = next_bit(child_bits, bit + 1)) {
+                grown[bit] = old[i];
+            }
+        } else {
+            capacity = static_cast<uint8_t>(child_capacity * 2);
+            grown = arena.new_children(capacity);
+            std::copy(old, old + child_count, grown);
+        }
+        if (child_capacity > 1) {
+            arena.delete_children(children.array, child_capacity);
+        }
+        children.array = grown;
+        child_capacity = capacity;
+    }
+    trie_node **array = slots();
+    if (child_capacity == num_chars) {
+        array[index] = node;
+    } else {
+        size_t position = child_rank(child_bits, index);
+        std::copy_backward(array + position, array + child_count, array + child_count + 1);
+        array[position] = node;
+    }
+    child_bits[index >> 6] |= uint64_t(1) << (index & 63);
+    ++child_count;
+}
+
+void trie_node::remove_child(node_arena &arena, char c) {
+    if (!child(c)) {
+        return;
+    }
+    size_t index = char_index(c);
+    trie_node **array = slots();
+    if (child_capacity == num_chars) {
+        array[index] = nullptr;
+    } else {
+        size_t position = child_rank(child_bits, index);
+        std::copy(array + position + 1, array + child_count, array + position);
+    }
+    child_bits[index >> 6] &= ~(uint64_t(1) << (index & 63));
+    if (--child_count == 0) {
+        release_children(arena);
+    }
+}
+
+void trie_node::release_children(node_arena &arena) {
+    if (child_capacity > 1) {
+        arena.delete_children(children.array, child_capacity);
+    }
+    children.array = nullptr;
+    child_bits[0] = child_bits[1] = 0;
+    child_count = 0;
+    child_capacity = 0;
+}
+
 //420 line just for fun
 
 trie::trie(const std::vector<std::string> &strings) {
@@ -19,69 +303,29 @@ trie::trie(const std::vector<std::string> &strings) {
 }
 
 bool trie::erase(const std::string &str) {
-    //nasetovaní
-    if (!currentNodePointer && str.length() == 0) {
-        if (m_root->is_terminal) {
-            m_size--;
-            m_root->is_terminal = false;
-            return true;
-        } else {
-            return false;
-        }
-    } else if (!currentNodePointer) {
-        currentNodePointer = m_root;
+    trie_node *node = m_root;
+    for (size_t i = 0; node && i < str.size(); ++i) {
+        node = node->child(str[i]);
     }
-    auto correspondingChild = (currentNodePointer)->children[int(str[0])];
-    //když to nikam nevede
-    if (!correspondingChild && str.length() != 0) {
-        currentNodePointer = nullptr;
+    if (!node || !node->is_terminal) {
         return false;
-    } else {
-        //kdyz mi dosel string
-        if (str.length() == 0) {
-            if (!(currentNodePointer)->is_terminal) {
-                currentNodePointer = nullptr;
-                return false;
-            } else {
-                m_size--;
-                (currentNodePointer)->is_terminal = false;
-                bool doLoop = (currentNodePointer)->is_terminal;
-                bool hasChildren;
-                trie_node *parent;
-                //deletion if branch is empty
-                while (!doLoop) {
-                    hasChildren = false;
-                    int index = int(currentNodePointer->payload);
-                    for (auto child: (currentNodePointer)->children) {
-                        if (child != nullptr) {
-                            hasChildren = true;
-                            break;
-                        }
-                    }
-                    if (!hasChildren && currentNodePointer != m_root) {
-                        parent = (currentNodePointer)->parent;
-                        delete currentNodePointer;
-                        parent->children[index] = nullptr;
-                        currentNodePointer = parent;
-                        doLoop = (currentNodePointer)->is_terminal;
-                    } else {
-                        doLoop = true;
-                    }
-                }
-                currentNodePointer = nullptr;
-                return true;
-            }
-        } else {
-            currentNodePointer = correspondingChild;
-            return erase(str.substr(1, str.length() - 1));
-        }
     }
+    node->is_terminal = false;
+    m_size--;
+    // odstraníme větev, která po slově zůstala prázdná
+    while (node != m_root && !node->is_terminal && !node->has_children()) {
+        trie_node *parent = node->parent;
+        parent->remove_child(m_arena, node->payload);
+        m_arena.delete_node(node);
+        node = parent;
+    }
+    return true;
 }
 
 
 bool trie::insert(const std::string &str) {
     if (!this->m_root) {
-        m_root = new trie_node();
+        m_root = m_arena.new_node();
     }
     trie_node *currentNode = m_root;
     const char *sptr = str.c_str();
@@ -93,62 +337,46 @@ bool trie::insert(const std::string &str) {
         m_size++;
     }
     while (*sptr) {
-        auto childPointer = &(currentNode->children[int(*sptr)]);
-        if (!*childPointer) {
-            *childPointer = new trie_node();
-            (*childPointer)->parent = currentNode;
-            (*childPointer)->payload = *sptr;
+        auto childNode = currentNode->child(*sptr);
+        if (!childNode) {
+            childNode = m_arena.new_node();
+            childNode->parent = currentNode;
+            childNode->payload = *sptr;
+            currentNode->add_child(m_arena, childNode);
         }
         if (!*(sptr + 1)) {
-            if ((*childPointer)->is_terminal) {
+            if (childNode->is_terminal) {
                 return false;
             }
-            (*childPointer)->is_terminal = true;
+            childNode->is_terminal = true;
             m_size++;
             return true;
         }
-        currentNode = *childPointer;
+        currentNode = childNode;
         sptr++;
     }
     return true;
 }
 
-trie::trie(const trie &rhs) {
-    m_root = new trie_node();
-    vector<string> words = {rhs.begin(), rhs.end()};
-    for (const string &word : words) {
-        insert(word);
-    }
+trie::trie(const trie &rhs) : m_size(rhs.m_size) {
+    size_t words = 0;
+    m_root = rhs.m_root ? clone(rhs.m_root, words) : m_arena.new_node();
 }
 
-trie::trie(trie &&rhs) {
-    m_root = new trie_node();
-    vector<string> words = {rhs.begin(), rhs.end()};
-    for (const string &word : words) {
-        insert(word);
-    }
+trie::trie(trie &&rhs) noexcept : m_root(rhs.m_root), m_size(rhs.m_size) {
+    // uzly patří do paměti `rhs`, převezmeme ji celou; `rhs` zůstane bez kořene
+    m_arena.swap(rhs.m_arena);
+    rhs.m_root = nullptr;
+    rhs.m_size = 0;
 }
 
 trie::trie() {
-    m_root = new trie_node();
+    m_root = m_arena.new_node();
     m_size = 0;
 }
 
 trie::~trie() {
-    if (m_root) {
-        std::stack<trie_node *> nodes;
-        nodes.push(m_root);
-        while (!nodes.empty()) {
-            auto currentNode = nodes.top();
-            nodes.pop();
-            for (auto child : currentNode->children) {
-                if (child) {
-                    nodes.push(child);
-                }
-            }
-            delete currentNode;
-        }
-    }
+    // uzly nemají co uvolňovat, všechny zaniknou s bloky m_arena
 }
 
 size_t trie::size() const {
@@ -160,20 +388,23 @@ bool trie::empty() const {
 }
 
 bool trie::contains(const std::string &str) const {
+    if (!m_root) {
+        return false;
+    }
     const char *sptr = str.c_str();
     if (str.length() == 0 && m_root->is_terminal) {
         return true;
     }
     trie_node *current = m_root;
     while (*sptr) {
-        auto childp = &(current->children[int(*sptr)]);
-        if (!*childp) {
+        auto child = current->child(*sptr);
+        if (!child) {
             break;
         } else {
-            if (!*(sptr + 1) && (*childp)->is_terminal) {
+            if (!*(sptr + 1) && child->is_terminal) {
                 return true;
             }
-            current = *childp;
+            current = child;
         }
         sptr++;
     }
@@ -184,20 +415,11 @@ trie::const_iterator trie::begin() const {
     if (m_size == 0) {
         return trie::const_iterator();
     }
-    currentNodePointer = m_root;
-    while (true) {
-        if (currentNodePointer->is_terminal) {
-            auto tmpNode = currentNodePointer;
-            currentNodePointer = nullptr;
-            return trie::const_iterator(tmpNode);
-        }
-        for (auto child: currentNodePointer->children) {
-            if (child != nullptr) {
-                currentNodePointer = child;
-                break;
-            }
-        }
+    trie::const_iterator it(m_root);
+    if (!m_root->is_terminal) {
+        ++it;
     }
+    return it;
 }
 
 trie::const_iterator trie::end() const {
@@ -205,32 +427,51 @@ trie::const_iterator trie::end() const {
 }
 
 trie &trie::operator=(const trie &rhs) {
-    if (this->m_root != rhs.m_root) {
-        this->~trie();
-        this->m_root = new trie_node;
-        this->m_size = 0;
-        vector<string> words = {rhs.begin(), rhs.end()};
-        for (const string &word : words) {
-            insert(word);
-        }
+    if (this != &rhs) {
+        trie copy(rhs);
+        swap(copy);
     }
     return *this;
 }
 
-trie &trie::operator=(trie &&rhs) {
-    if (this->m_root != rhs.m_root) {
-        this->~trie();
-        this->m_root = new trie_node;
-        this->m_size = 0;
-        vector<string> words = {rhs.begin(), rhs.end()};
-        for (const string &word : words) {
-            insert(word);
-        }
+trie &trie::operator=(trie &&rhs) noexcept {
+    if (this != &rhs) {
+        m_arena.clear();
+        m_arena.swap(rhs.m_arena);
+        m_root = rhs.m_root;
+        m_size = rhs.m_size;
+        rhs.m_root = nullptr;
+        rhs.m_size = 0;
     }
     return *this;
 }
 
+trie_node *trie::clone(const trie_node *source, size_t &words) {
+    // kopie bez rekurze: dvojice (zdroj, kopie), jejichž potomky je třeba zkopírovat;
+    // potomci se přidávají v pořadí znaků, takže se pole jen prodlužují
+    trie_node *root = m_arena.new_node();
+    root->payload = source->payload;
+    root->is_terminal = source->is_terminal;
+    words += source->is_terminal;
+    std::vector<std::pair<const trie_node *, trie_node *>> pending{{source, root}};
+    while (!pending.empty()) {
+        auto item = pending.back();
+        pending.pop_back();
+        item.first->for_each_child([&](const trie_node *child) {
+            trie_node *copy = m_arena.new_node();
+            copy->parent = item.second;
+            copy->payload = child->payload;
+            copy->is_terminal = child->is_terminal;
+            words += child->is_terminal;
+            item.second->add_child(m_arena, copy);
+            pending.emplace_back(child, copy);
+        });
+    }
+    return root;
+}
+
 void trie::swap(trie &rhs) {
+    m_arena.swap(rhs.m_arena);
     auto tmpNode = m_root;
     auto tmpSize = m_size;
     m_root = rhs.m_root;
@@ -252,99 +493,276 @@ bool trie::operator<(const trie &rhs) const {
            lexicographical_compare(wordsT1.begin(), wordsT1.end(), wordsT2.begin(), wordsT2.end());
 }
 
-//todo
 trie trie::operator&(const trie &rhs) const {
-    vector<string> words = {rhs.begin(), rhs.end()};
-    vector<string> intersectingWords;
-    for (auto word:words) {
-        if (contains(word)) {
-            intersectingWords.push_back(word);
+    trie result;
+    if (!m_root || !rhs.m_root) {
+        return result;
+    }
+    // trojice (uzel této trie, uzel rhs, uzel výsledku) se stejným klíčem
+    struct item {
+        const trie_node *lhs;
+        const trie_node *rhs;
+        trie_node *out;
+    };
+    std::vector<item> pending{{m_root, rhs.m_root, result.m_root}};
+    std::vector<trie_node *> created;
+    while (!pending.empty()) {
+        item current = pending.back();
+        pending.pop_back();
+        created.push_back(current.out);
+        if (current.lhs->is_terminal && current.rhs->is_terminal) {
+            current.out->is_terminal = true;
+            ++result.m_size;
         }
+        for_each_common_child(current.lhs, current.rhs, [&](char c) {
+            trie_node *child = result.m_arena.new_node();
+            child->parent = current.out;
+            child->payload = c;
+            current.out->add_child(result.m_arena, child);
+            pending.push_back({current.lhs->child(c), current.rhs->child(c), child});
+        });
     }
-    trie tmpTrie = trie(intersectingWords);
-    return tmpTrie;
+    result.prune(created);
+    return result;
 }
 
-//todo
 trie trie::operator|(const trie &rhs) const {
-    vector<string> words = {rhs.begin(), rhs.end()};
-    vector<string> words2 = {this->begin(), this->end()};
-    words.insert(words.end(), make_move_iterator(words2.begin()), make_move_iterator(words2.end()));
-    trie tmpTrie = trie(words);
-    return tmpTrie;
+    if (size() < rhs.size()) {
+        return rhs | *this;
+    }
+    trie result(*this);
+    result |= rhs;
+    return result;
 }
 
-std::vector<std::string> trie::search_by_prefix(const string &prefix) const {
-    vector<string> words = {this->begin(), this->end()};
-    vector<string> ret;
-    for (const auto &word: words) {
-        if (word.substr(0, prefix.length()) == prefix) {
-            ret.push_back(word);
+trie trie::operator-(const trie &rhs) const {
+    trie result(*this);
+    result -= rhs;
+    return result;
+}
+
+trie &trie::operator|=(const trie &rhs) {
+    if (this == &rhs || !rhs.m_root) {
+        return *this;
+    }
+    if (!m_root) {
+        m_root = m_arena.new_node();
+    }
+    std::vector<std::pair<trie_node *, const trie_node *>> pending{{m_root, rhs.m_root}};
+    while (!pending.empty()) {
+        auto current = pending.back();
+        pending.pop_back();
+        trie_node *node = current.first;
+        const trie_node *other = current.second;
+        if (other->is_terminal && !node->is_terminal) {
+            node->is_terminal = true;
+            ++m_size;
         }
+        other->for_each_child([&](const trie_node *other_child) {
+            if (trie_node *child = node->child(other_child->payload)) {
+                pending.emplace_back(child, other_child);
+            } else {
+                trie_node *copy = clone(other_child, m_size);
+                copy->parent = node;
+                node->add_child(m_arena, copy);
+            }
+        });
     }
-    return ret;
+    return *this;
 }
 
-std::vector<std::string> trie::get_prefixes(const string &str) const {
-    vector<string> words = {this->begin(), this->end()};
-    vector<string> ret;
-    for (auto const word:words) {
-        if (!str.find(word)) {
-            ret.push_back(word);
+trie &trie::operator&=(const trie &rhs) {
+    if (this == &rhs || !m_root) {
+        return *this;
+    }
+    if (!rhs.m_root) {
+        m_arena.clear();
+        m_root = m_arena.new_node();
+        m_size = 0;
+        return *this;
+    }
+    std::vector<std::pair<trie_node *, const trie_node *>> pending{{m_root, rhs.m_root}};
+    std::vector<trie_node *> visited;
+    while (!pending.empty()) {
+        auto current = pending.back();
+        pending.pop_back();
+        trie_node *node = current.first;
+        const trie_node *other = current.second;
+        visited.push_back(node);
+        if (node->is_terminal && !other->is_terminal) {
+            node->is_terminal = false;
+            --m_size;
         }
+        // potomky bez protějšku v rhs uvolníme celé, do společných sestoupíme
+        for_each_missing_child(node, other, [&](char c) {
+            trie_node *child = node->child(c);
+            node->remove_child(m_arena, c);
+            m_size -= free_subtree(child);
+        });
+        node->for_each_child([&](trie_node *child) { pending.emplace_back(child, other->child(child->payload)); });
     }
-    return ret;
+    prune(visited);
+    return *this;
 }
 
-trie::const_iterator::const_iterator(const trie_node *node) {
-    this->current_node = node;
+trie &trie::operator-=(const trie &rhs) {
+    if (!m_root || !rhs.m_root) {
+        return *this;
+    }
+    if (this == &rhs) {
+        m_arena.clear();
+        m_root = m_arena.new_node();
+        m_size = 0;
+        return *this;
+    }
+    std::vector<std::pair<trie_node *, const trie_node *>> pending{{m_root, rhs.m_root}};
+    std::vector<trie_node *> visited;
+    while (!pending.empty()) {
+        auto current = pending.back();
+        pending.pop_back();
+        trie_node *node = current.first;
+        const trie_node *other = current.second;
+        visited.push_back(node);
+        if (node->is_terminal && other->is_terminal) {
+            node->is_terminal = false;
+            --m_size;
+        }
+        for_each_common_child(node, other, [&](char c) { pending.emplace_back(node->child(c), other->child(c)); });
+    }
+    prune(visited);
+    return *this;
 }
 
-//prefix
-trie::const_iterator &trie::const_iterator::operator++() {
-    bool goDown = true;
-    bool goUp = false;
-    while (goDown) {
-        goDown = true;
-        bool hasChildren = false;
-        for (auto child: current_node->children) {
-            if (child != nullptr) {
-                current_node = child;
-                hasChildren = true;
-                if (current_node->is_terminal) {
-                    goDown = false;
-                    goUp = false;
-                }
-                break;
+size_t trie::free_subtree(trie_node *node) {
+    size_t words = 0;
+    std::vector<trie_node *> nodes{node};
+    while (!nodes.empty()) {
+        node = nodes.back();
+        nodes.pop_back();
+        words += node->is_terminal;
+        node->for_each_child([&](trie_node *child) { nodes.push_back(child); });
+        node->release_children(m_arena);
+        m_arena.delete_node(node);
+    }
+    return words;
+}
+
+void trie::prune(const std::vector<trie_node *> &nodes) {
+    // potomci jsou v `nodes` až za rodiči, odzadu se tedy uvolněná větev odstraní celá
+    for (auto it = nodes.rbegin(); it != nodes.rend(); ++it) {
+        trie_node *node = *it;
+        if (node != m_root && !node->is_terminal && !node->has_children()) {
+            node->parent->remove_child(m_arena, node->payload);
+            m_arena.delete_node(node);
+        }
+    }
+}
+
+const size_t trie::no_limit;
+
+std::vector<std::string> trie::search_by_prefix(const string &prefix, size_t limit) const {
+    vector<string> ret;
+    for_each_with_prefix(prefix, [&ret](const string &word) { ret.push_back(word); }, limit);
+    return ret;
+}
+
+size_t trie::for_each_with_prefix(const std::string &prefix, const word_callback &fn, size_t limit) const {
+    const trie_node *start = m_root;
+    for (size_t i = 0; start && i < prefix.size(); ++i) {
+        start = start->child(prefix[i]);
+    }
+    if (!start || limit == 0) {
+        return 0;
+    }
+    // průchod podstromem do hloubky přes ukazatele na předky; klíč se mění o jeden znak
+    size_t count = 0;
+    string key = prefix;
+    const trie_node *node = start;
+    while (true) {
+        if (node->is_terminal) {
+            fn(key);
+            if (++count == limit) {
+                return count;
             }
         }
-        if (!hasChildren) {
-            goUp = true;
+        if (auto child = node->first_child()) {
+            node = child;
+            key += child->payload;
+            continue;
         }
-        while (goUp) {
-            if (current_node->parent == nullptr) {
-                goUp = false;
-                goDown = false;
-                current_node = nullptr;
+        while (node != start) {
+            auto sibling = node->parent->next_child(node->payload);
+            key.pop_back();
+            if (sibling) {
+                node = sibling;
+                key += sibling->payload;
                 break;
             }
-            for (int i = int(current_node->payload); i++ < 127;) {
-                auto child = current_node->parent->children[i];
-                if (child != nullptr) {
-                    current_node = current_node->parent->children[i];
-                    if (current_node->is_terminal) {
-                        goDown = false;
-                    }
-                    goUp = false;
-                    break;
-                }
-            }
-            if (goUp) {
+            node = node->parent;
+        }
+        if (node == start) {
+            return count;
+        }
+    }
+}
+
+std::vector<std::string> trie::get_prefixes(const string &str, size_t limit) const {
+    vector<string> ret;
+    for_each_prefix_of(str, [&ret](const string &word) { ret.push_back(word); }, limit);
+    return ret;
+}
+
+size_t trie::for_each_prefix_of(const std::string &str, const word_callback &fn, size_t limit) const {
+    size_t count = 0;
+    string key;
+    key.reserve(str.size());
+    const trie_node *node = m_root;
+    for (size_t i = 0; node && count < limit; ++i) {
+        if (node->is_terminal) {
+            fn(key);
+            ++count;
+        }
+        if (i == str.size()) {
+            break;
+        }
+        node = node->child(str[i]);
+        key += str[i];
+    }
+    return count;
+}
+
+trie::const_iterator::const_iterator(const trie_node *node) : current_node(node) {
+    for (; node && node->parent; node = node->parent) {
+        m_key += node->payload;
+    }
+    std::reverse(m_key.begin(), m_key.end());
+}
+
+//prefix
+trie::const_iterator &trie::const_iterator::operator++() {
+    // průchod do hloubky: dolů k prvnímu potomkovi, jinak nahoru k nejbližšímu dalšímu sourozenci
+    while (true) {
+        if (auto child = current_node->first_child()) {
+            current_node = child;
+            m_key += child->payload;
+        } else {
+            const trie_node *sibling = nullptr;
+            while (current_node->parent && !(sibling = current_node->parent->next_child(current_node->payload))) {
                 current_node = current_node->parent;
+                m_key.pop_back();
+            }
+            if (!sibling) {
+                current_node = nullptr;
+                m_key.clear();
+                return *this;
             }
+            current_node = sibling;
+            m_key.back() = sibling->payload;
+        }
+        if (current_node->is_terminal) {
+            return *this;
         }
     }
-    return *this;
 }
 
 //postfix
@@ -355,14 +773,11 @@ trie::const_iterator trie::const_iterator::operator++(int) {
 }
 
 trie::const_iterator::reference trie::const_iterator::operator*() const {
-    vector<char> chars;
-    auto tmpNode = current_node;
-    string ret;
-    while (tmpNode->parent != nullptr) {
-        ret.insert(ret.begin(), tmpNode->payload);
-        tmpNode = tmpNode->parent;
-    }
-    return ret;
+    return m_key;
+}
+
+const std::string &trie::const_iterator::key() const {
+    return m_key;
 }
 
 bool trie::const_iterator::operator==(const trie::const_iterator &rhs) const {
@@ -414,7 +829,7 @@ void swap(trie &lhs, trie &rhs) {
  */
 std::ostream &operator<<(std::ostream &out, trie const &trie) {
     for(auto it = trie.begin(); it != trie.end(); ++it){
-        out<<*it<<endl;
+        out<<it.key()<<endl;
     }
     return out;
 };
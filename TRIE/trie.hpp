@@ -2,23 +2,167 @@
 
 #include <vector>
 #include <string>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <iterator>
+#include <limits>
 #include <iosfwd>
 
 // Předpokládáme pouze základní ASCII znaky
 static const size_t num_chars = 128;
 
+struct trie_node;
+
+/**
+ * Paměť pro uzly jedné trie a jejich pole potomků.
+ *
+ * Uzly i pole se přidělují postupně z velkých bloků (slabů) po 64 KB, takže
+ * stavba velké trie znamená jen několik alokací a zrušení celé trie (nebo
+ * clear()) uvolní jen bloky, bez procházení uzlů. Uvolněné uzly a pole se
+ * drží v seznamech volných míst (pro každou velikost pole zvlášť) a znovu
+ * se použijí při dalším vkládání.
+ */
+class node_arena {
+public:
+    node_arena() = default;
+
+    ~node_arena();
+
+    node_arena(const node_arena &) = delete;
+
+    node_arena &operator=(const node_arena &) = delete;
+
+    //! Vrátí nový prázdný uzel.
+    trie_node *new_node();
+
+    //! Vrátí uzel k dalšímu použití (jeho pole potomků už musí být vrácené).
+    void delete_node(trie_node *node);
+
+    //! Vrátí pole pro `capacity` potomků (mocnina dvou nebo num_chars), husté pole vynulované.
+    trie_node **new_children(size_t capacity);
+
+    void delete_children(trie_node **array, size_t capacity);
+
+    //! Uvolní všechny bloky; všechny uzly a pole z této paměti tím zaniknou.
+    void clear();
+
+    //! Prohodí obsah s `rhs` v O(1).
+    void swap(node_arena &rhs);
+
+    //! Počet alokovaných bloků.
+    size_t slab_count() const;
+
+private:
+    //! Počet velikostí polí potomků (2, 4, ... 32 a num_chars).
+    static const size_t size_classes = 6;
+
+    struct free_block {
+        free_block *next;
+    };
+
+    void *allocate(size_t bytes);
+
+    static size_t size_class(size_t capacity);
+
+    std::vector<char *> m_slabs;
+    char *m_next = nullptr;
+    char *m_end = nullptr;
+    free_block *m_free_nodes = nullptr;
+    free_block *m_free_children[size_classes] = {};
+};
+
+/**
+ * Uzel trie s kompaktně uloženými potomky.
+ *
+ * Místo pole 128 ukazatelů (1 KB na uzel i s jediným potomkem) si uzel drží
+ * bitmapu znaků, pro které má potomka, a pole jen skutečných potomků
+ * seřazené podle znaku; index potomka je počet nastavených bitů pod jeho
+ * znakem. Jediný potomek (řetězce uzlů v dlouhých slovech) se drží přímo
+ * v uzlu bez pole. Když má uzel víc než `dense_threshold` potomků, přejde
+ * na husté pole `num_chars` ukazatelů indexované přímo znakem, aby se
+ * vkládání nemuselo posouvat ve velkém poli.
+ *
+ * Uzly i pole potomků patří do node_arena dané trie, proto se uzel při
+ * zániku o nic nestará a metody, které mění pole potomků, ji dostávají.
+ */
 struct trie_node {
-    trie_node *children[num_chars] = {}; //!< pole ukazatelů na přímé následovníky daného uzlu
-    trie_node *parent = nullptr;         //!< ukazatel na přímého předka daného uzlu
-    char payload = 0;                    //!< znak, který tento uzel reprezentuje
-    bool is_terminal = false;            //!< označuje, jestli v tomto uzlu končí slovo
+    //! Od kolika potomků se použije husté pole.
+    static const size_t dense_threshold = 32;
+
+    trie_node() = default;
+
+    trie_node(const trie_node &) = delete;
+
+    trie_node &operator=(const trie_node &) = delete;
+
+    //! Vrátí potomka pro znak `c`, nebo nullptr.
+    trie_node *child(char c) const;
+
+    //! Vrátí potomka s nejmenším znakem, nebo nullptr.
+    trie_node *first_child() const;
+
+    //! Vrátí potomka s nejmenším znakem větším než `c`, nebo nullptr.
+    trie_node *next_child(char c) const;
+
+    bool has_children() const;
+
+    //! Zapojí `node` jako potomka pro znak `node->payload` (ten ještě nesmí existovat).
+    void add_child(node_arena &arena, trie_node *node);
+
+    //! Odpojí potomka pro znak `c` (neuvolní ho).
+    void remove_child(node_arena &arena, char c);
+
+    //! Vrátí pole potomků do `arena` (samotné potomky ne).
+    void release_children(node_arena &arena);
+
+    //! Zavolá `fn(child)` pro všechny potomky v pořadí znaků.
+    template <typename Fn>
+    void for_each_child(Fn fn) const {
+        for (auto node = first_child(); node; node = next_child(node->payload)) {
+            fn(node);
+        }
+    }
+
+    uint64_t child_bits[2] = {}; //!< bitmapa znaků, pro které existuje potomek
+    union {
+        trie_node *single;  //!< jediný potomek (child_capacity == 1)
+        trie_node **array;  //!< potomci seřazení podle znaku, nebo husté pole num_chars
+    } children = {nullptr};
+    trie_node *parent = nullptr; //!< ukazatel na přímého předka daného uzlu
+    uint8_t child_count = 0;     //!< počet potomků
+    uint8_t child_capacity = 0;  //!< kolik potomků se vejde (1 přímo v uzlu, num_chars znamená husté pole)
+    char payload = 0;            //!< znak, který tento uzel reprezentuje
+    bool is_terminal = false;    //!< označuje, jestli v tomto uzlu končí slovo
+
+private:
+    //! Potomci jako pole (i když je jediný uložený přímo v uzlu).
+    trie_node *const *slots() const;
+
+    trie_node **slots();
 };
 
+/**
+ * Množina řetězců uložená jako prefixový strom.
+ *
+ * Metody `const` (vyhledávání, iterace, dotazy na prefixy, porovnání) nemají
+ * žádný sdílený stav mimo trii a nic v ní nemění, takže je lze volat souběžně
+ * z více vláken, dokud trii žádné vlákno nemění. Souběžný zápis se čtením
+ * nebo s jiným zápisem musí volající synchronizovat sám; různé trie jsou
+ * na sobě nezávislé.
+ */
 class trie {
 public:
+    /**
+     * Iterátor přes slova v lexikografickém pořadí.
+     *
+     * Drží si klíč aktuálního slova a při posunu ho mění jen o znaky, které
+     * přibudou nebo ubudou cestou stromem (zásobníkem cesty jsou ukazatele
+     * na předky v uzlech), takže průchod celou trií je lineární v počtu uzlů.
+     */
     class const_iterator {
         const trie_node *current_node = nullptr;
+        std::string m_key; //!< klíč slova v `current_node`
 
         friend std::ostream &operator<<(std::ostream &os, trie::const_iterator const &i);
 
@@ -32,14 +176,19 @@ public:
 
         const_iterator() = default;
 
+        //! Iterátor na slovo v uzlu `node`; klíč jednou složí z předků.
         const_iterator(const trie_node *node);
 
         const_iterator &operator++();
 
         const_iterator operator++(int);
 
+        //! Kopie klíče aktuálního slova.
         reference operator*() const;
 
+        //! Klíč aktuálního slova bez kopírování; platí do dalšího posunu iterátoru.
+        const std::string &key() const;
+
         //vysvětlit co to má dělat
         bool operator==(const const_iterator &rhs) const;
 
@@ -53,13 +202,21 @@ public:
 
     trie();
 
+    //! Zkopíruje strukturu uzlů `rhs` do vlastní paměti, bez skládání slov.
     trie(const trie &rhs);
 
     trie &operator=(const trie &rhs);
 
-    trie(trie &&rhs);
+    /**
+     * Převezme uzly i paměť `rhs`, nic nekopíruje ani nealokuje.
+     * Z `rhs` zůstane prázdná trie, do které lze dál vkládat.
+     *
+     * Složitost: O(1)
+     */
+    trie(trie &&rhs) noexcept;
 
-    trie &operator=(trie &&rhs);
+    //! Uvolní vlastní uzly a převezme uzly `rhs`, viz přesouvací konstruktor.
+    trie &operator=(trie &&rhs) noexcept;
 
     ~trie();
 
@@ -90,21 +247,47 @@ public:
      */
     bool empty() const;
 
+    //! Zpětné volání pro dotazy, které výsledky předávají postupně.
+    using word_callback = std::function<void(const std::string &)>;
+
+    //! Hodnota `limit`, která počet výsledků neomezuje.
+    static const size_t no_limit = std::numeric_limits<size_t>::max();
+
     /**
      * Vrátí všechny prvky trie, které začínají daným prefixem.
      *
      * Prefixy jsou inkluzivní, tj. search_by_prefix("abc") vrátí mezi výsledky
      * i "abc", pokud je "abc" v trii.
+     *
+     * Výsledky jsou v lexikografickém pořadí; s `limit` vrátí jen prvních
+     * `limit` z nich (např. první doplnění pro našeptávač).
      */
-    std::vector<std::string> search_by_prefix(const std::string &prefix) const;
+    std::vector<std::string> search_by_prefix(const std::string &prefix, size_t limit = no_limit) const;
+
+    /**
+     * Zavolá `fn` postupně pro prvky začínající `prefix` v lexikografickém
+     * pořadí, nejvýše `limit`-krát, a vrátí počet volání.
+     *
+     * Sestoupí k uzlu prefixu a prochází jen jeho podstrom; předávaný řetězec
+     * platí jen po dobu volání.
+     */
+    size_t for_each_with_prefix(const std::string &prefix, const word_callback &fn, size_t limit = no_limit) const;
 
     /**
      * Vrátí všechny řetězce z trie, jež jsou prefixem daného řetězce.
      *
      * Prefixy jsou inkluzivní, tj. get_prefixes("abc") vrátí mezi výsledky
      * i "abc", pokud je "abc" v trii.
+     *
+     * Výsledky jsou seřazené od nejkratšího; s `limit` vrátí jen prvních `limit`.
      */
-    std::vector<std::string> get_prefixes(const std::string &str) const;
+    std::vector<std::string> get_prefixes(const std::string &str, size_t limit = no_limit) const;
+
+    /**
+     * Zavolá `fn` postupně pro prvky, které jsou prefixem `str`, od nejkratšího,
+     * nejvýše `limit`-krát, a vrátí počet volání. Prochází jen cestu `str`.
+     */
+    size_t for_each_prefix_of(const std::string &str, const word_callback &fn, size_t limit = no_limit) const;
 
     const_iterator begin() const;
 
@@ -141,16 +324,69 @@ public:
      *
      * Složitost: Implementace by neměla zbytečně procházet prvky, o kterých už ví,
      *            že v druhé trii být nemohou (např. ["aa", "ab", "ac"...], ["x"]).
+     *
+     * Obě trie se procházejí současně a sestupuje se jen do potomků, které
+     * mají oba uzly (průnik bitmap), takže složitost je úměrná společné části
+     * stromů, ne počtu slov.
      */
     trie operator&(trie const &rhs) const;
 
     /**
      * Vrátí novou trii, která obsahuje sjednocení této a `rhs`, tj. řežezce
      * přítomné alespoň v jedné z nich.
+     *
+     * Zkopíruje větší z trií a do kopie přidá druhou, viz operator|=.
      */
     trie operator|(trie const &rhs) const;
 
+    /**
+     * Vrátí novou trii s řetězci této trie, které nejsou v `rhs`.
+     *
+     * Zkopíruje tuto trii a odebere z kopie `rhs`, viz operator-=.
+     */
+    trie operator-(trie const &rhs) const;
+
+    /**
+     * Přidá do této trie všechny řetězce z `rhs`.
+     *
+     * Sestupuje jen po společných cestách; podstromy `rhs`, které tu chybí,
+     * zkopíruje celé jako uzly, bez skládání slov.
+     */
+    trie &operator|=(trie const &rhs);
+
+    /**
+     * Ponechá v této trii jen řetězce, které jsou i v `rhs`.
+     *
+     * Podstromy, které v `rhs` nemají protějšek, uvolní celé najednou.
+     */
+    trie &operator&=(trie const &rhs);
+
+    /**
+     * Odebere z této trie všechny řetězce z `rhs`.
+     *
+     * Sestupuje jen po společných cestách, podstromy jen v jedné z trií přeskočí.
+     */
+    trie &operator-=(trie const &rhs);
+
 private:
+    /**
+     * Zkopíruje podstrom `source` (z jiné trie) do m_arena a vrátí kopii jeho
+     * kořene; k `words` přičte počet zkopírovaných slov.
+     */
+    trie_node *clone(const trie_node *source, size_t &words);
+
+    //! Vrátí uzel `node` i celý jeho podstrom do m_arena a vrátí počet slov, která v něm byla.
+    size_t free_subtree(trie_node *node);
+
+    /**
+     * Odstraní uzly z `nodes` (rodiče před potomky), ve kterých nekončí slovo
+     * a které po operaci nemají potomky; kořen nechá.
+     */
+    void prune(const std::vector<trie_node *> &nodes);
+
+    //! paměť, ze které jsou všechny uzly této trie
+    node_arena m_arena;
+
     //! ukazatel na kořenový uzel stromu
     trie_node *m_root = nullptr;
 
@@ -0,0 +1,482 @@
+#include "async_read.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define WC_HAVE_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+namespace {
+    //! Nejvýše tolik vláken čte soubory, když není io_uring (jinak jedno na jádro, aspoň dvě).
+    const size_t max_reader_threads = 16;
+
+#if !defined(_WIN32)
+    /**
+     * Otevře soubor a zjistí jeho velikost. Vrací deskriptor, který je
+     * potřeba ještě přečíst, nebo -1, pokud je `file` už hotový (nešel
+     * otevřít, je velký nebo prázdný).
+     */
+    int open_file(const std::string &name, size_t large_file_size, loaded_file &file, size_t &size) {
+        int fd = ::open(name.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return -1;
+        }
+        struct stat st{};
+        if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+            // roury a speciální soubory nenačítáme, zpracuje je volající jako velké
+            ::close(fd);
+            file.opened = true;
+            file.large = true;
+            return -1;
+        }
+        file.opened = true;
+        size = static_cast<size_t>(st.st_size);
+        if (size > large_file_size) {
+            file.large = true;
+        }
+        if (size == 0 || file.large) {
+            ::close(fd);
+            return -1;
+        }
+        file.data.resize(size);
+        return fd;
+    }
+
+    //! Blokující načtení celého souboru.
+    void load_file(const std::string &name, size_t large_file_size, loaded_file &file) {
+        size_t size = 0;
+        int fd = open_file(name, large_file_size, file, size);
+        if (fd < 0) {
+            return;
+        }
+        size_t done = 0;
+        while (done < size) {
+            ssize_t n = ::pread(fd, file.data.data() + done, size - done, static_cast<off_t>(done));
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0) {
+                file.opened = false;
+                break;
+            }
+            if (n == 0) {
+                // soubor se mezitím zkrátil
+                break;
+            }
+            done += static_cast<size_t>(n);
+        }
+        file.data.resize(file.opened ? done : 0);
+        ::close(fd);
+    }
+#else
+    void load_file(const std::string &name, size_t large_file_size, loaded_file &file) {
+        std::FILE *in = std::fopen(name.c_str(), "rb");
+        if (!in) {
+            return;
+        }
+        file.opened = true;
+        char buffer[1 << 16];
+        size_t n;
+        while ((n = std::fread(buffer, 1, sizeof(buffer), in)) > 0) {
+            file.data.insert(file.data.end(), buffer, buffer + n);
+            if (file.data.size() > large_file_size) {
+                file.data.clear();
+                file.large = true;
+                break;
+            }
+        }
+        std::fclose(in);
+    }
+#endif
+}
+
+#ifdef WC_HAVE_IO_URING
+/**
+ * Minimální obsluha io_uring přímo přes systémová volání (bez liburing):
+ * namapované fronty požadavků (SQ) a dokončení (CQ) a pole záznamů SQE.
+ */
+struct async_file_reader::ring {
+    int fd = -1;
+    void *sq_ptr = nullptr;
+    void *cq_ptr = nullptr;
+    size_t sq_size = 0;
+    size_t cq_size = 0;
+    io_uring_sqe *sqes = nullptr;
+    size_t sqes_size = 0;
+
+    unsigned *sq_tail = nullptr;
+    unsigned *sq_mask = nullptr;
+    unsigned *sq_array = nullptr;
+    unsigned *cq_head = nullptr;
+    unsigned *cq_tail = nullptr;
+    unsigned *cq_mask = nullptr;
+    io_uring_cqe *cqes = nullptr;
+    unsigned entries = 0;
+    unsigned pending_submit = 0;
+
+    bool setup(unsigned requested) {
+        io_uring_params params{};
+        fd = static_cast<int>(::syscall(__NR_io_uring_setup, requested, &params));
+        if (fd < 0) {
+            return false;
+        }
+        entries = params.sq_entries;
+        sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single_mmap) {
+            sq_size = cq_size = std::max(sq_size, cq_size);
+        }
+        sq_ptr = ::mmap(nullptr, sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (sq_ptr == MAP_FAILED) {
+            sq_ptr = nullptr;
+            return false;
+        }
+        cq_ptr = single_mmap ? sq_ptr : ::mmap(nullptr, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                               fd, IORING_OFF_CQ_RING);
+        if (cq_ptr == MAP_FAILED) {
+            cq_ptr = nullptr;
+            return false;
+        }
+        sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        void *sqes_ptr = ::mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                                IORING_OFF_SQES);
+        if (sqes_ptr == MAP_FAILED) {
+            return false;
+        }
+        sqes = static_cast<io_uring_sqe *>(sqes_ptr);
+
+        auto *sq = static_cast<char *>(sq_ptr);
+        auto *cq = static_cast<char *>(cq_ptr);
+        sq_tail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+        sq_mask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+        sq_array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+        cq_head = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+        cq_tail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+        cq_mask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    ~ring() {
+        close();
+    }
+
+    //! Odmapuje fronty a zavře ring; jádro zbylé požadavky zruší samo.
+    void close() {
+        if (sqes) {
+            ::munmap(sqes, sqes_size);
+        }
+        if (cq_ptr && cq_ptr != sq_ptr) {
+            ::munmap(cq_ptr, cq_size);
+        }
+        if (sq_ptr) {
+            ::munmap(sq_ptr, sq_size);
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        sqes = nullptr;
+        sq_ptr = cq_ptr = nullptr;
+        fd = -1;
+    }
+
+    //! Zařadí čtení `length` bajtů od `offset`; volající hlídá, aby požadavků nebylo víc než `entries`.
+    void queue_read(int file, char *buffer, size_t length, size_t offset, uint64_t user_data) {
+        unsigned tail = *sq_tail;
+        unsigned index = tail & *sq_mask;
+        io_uring_sqe &sqe = sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_READ;
+        sqe.fd = file;
+        sqe.addr = reinterpret_cast<uint64_t>(buffer);
+        sqe.len = static_cast<uint32_t>(std::min<size_t>(length, 1u << 30));
+        sqe.off = offset;
+        sqe.user_data = user_data;
+        sq_array[index] = index;
+        __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+        ++pending_submit;
+    }
+
+    //! Odešle zařazené požadavky a počká aspoň na `wait` dokončení.
+    bool submit_and_wait(unsigned wait) {
+        while (true) {
+            long ret = ::syscall(__NR_io_uring_enter, fd, pending_submit, wait,
+                                 wait ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0);
+            if (ret >= 0) {
+                pending_submit -= std::min(pending_submit, static_cast<unsigned>(ret));
+                return true;
+            }
+            if (errno != EINTR) {
+                return false;
+            }
+        }
+    }
+
+    //! Vezme zpět zařazené, ještě neodeslané požadavky a pro každý zavolá `fn(user_data)`.
+    template <typename Fn>
+    void unqueue(Fn &&fn) {
+        unsigned tail = *sq_tail;
+        for (; pending_submit > 0; --pending_submit) {
+            --tail;
+            fn(sqes[sq_array[tail & *sq_mask]].user_data);
+        }
+        __atomic_store_n(sq_tail, tail, __ATOMIC_RELEASE);
+    }
+
+    //! Zavolá `fn(user_data, res)` pro každé hotové dokončení.
+    template <typename Fn>
+    void reap(Fn &&fn) {
+        unsigned head = *cq_head;
+        unsigned tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            const io_uring_cqe &cqe = cqes[head & *cq_mask];
+            fn(cqe.user_data, cqe.res);
+            ++head;
+        }
+        __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+    }
+};
+#else
+struct async_file_reader::ring {
+};
+#endif
+
+bool parse_read_backend(const std::string &name, read_backend &backend) {
+    if (name == "auto") {
+        backend = read_backend::automatic;
+    } else if (name == "threads") {
+        backend = read_backend::threads;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+async_file_reader::async_file_reader(const std::vector<std::string> &files, read_backend backend,
+                                     size_t in_flight, size_t large_file_size)
+        : m_files(files), m_in_flight(std::max<size_t>(in_flight, 1)), m_large_file_size(large_file_size) {
+#ifdef WC_HAVE_IO_URING
+    if (backend == read_backend::automatic) {
+        auto candidate = std::make_unique<ring>();
+        if (candidate->setup(static_cast<unsigned>(m_in_flight))) {
+            m_ring = std::move(candidate);
+        }
+    }
+#endif
+    if (m_ring) {
+        m_running_producers = 1;
+        m_threads.emplace_back(&async_file_reader::run_io_uring, this);
+    } else {
+        // s načtenými daty v cache víc vláken, než je jader, jen přepíná kontext
+        size_t cores = std::max<size_t>(2, std::thread::hardware_concurrency());
+        size_t count = std::max<size_t>(1, std::min({max_reader_threads, cores, m_in_flight, files.size()}));
+        m_running_producers = count;
+        for (size_t i = 0; i < count; ++i) {
+            m_threads.emplace_back(&async_file_reader::run_threads, this);
+        }
+    }
+}
+
+async_file_reader::~async_file_reader() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_changed.notify_all();
+    for (auto &thread : m_threads) {
+        thread.join();
+    }
+}
+
+const char *async_file_reader::backend_name() const {
+    return m_ring ? "io_uring" : "threads";
+}
+
+bool async_file_reader::next(loaded_file &file) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_changed.wait(lock, [this]() { return !m_ready.empty() || m_running_producers == 0; });
+    if (m_ready.empty()) {
+        return false;
+    }
+    file = std::move(m_ready.front());
+    m_ready.pop_front();
+    lock.unlock();
+    m_changed.notify_all();
+    return true;
+}
+
+bool async_file_reader::deliver(loaded_file &&file) {
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_changed.wait(lock, [this]() { return m_ready.size() < m_in_flight || m_stop; });
+        if (m_stop) {
+            return false;
+        }
+        m_ready.push_back(std::move(file));
+    }
+    m_changed.notify_all();
+    return true;
+}
+
+void async_file_reader::producer_finished() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        --m_running_producers;
+    }
+    m_changed.notify_all();
+}
+
+void async_file_reader::run_threads() {
+    size_t index;
+    while ((index = m_next_file++) < m_files.size()) {
+        loaded_file file;
+        file.index = index;
+        load_file(m_files[index], m_large_file_size, file);
+        if (!deliver(std::move(file))) {
+            break;
+        }
+    }
+    producer_finished();
+}
+
+void async_file_reader::run_io_uring() {
+#ifdef WC_HAVE_IO_URING
+    struct pending {
+        loaded_file file;
+        int fd = -1;
+        size_t done = 0;
+    };
+    std::vector<pending> slots(m_ring->entries);
+    std::vector<size_t> free_slots;
+    for (size_t i = slots.size(); i > 0; --i) {
+        free_slots.push_back(i - 1);
+    }
+    size_t next_file = 0;
+    bool ok = true;      //!< false po zastavení (deliver odmítl soubor)
+    bool failed = false; //!< io_uring_enter selhalo natrvalo
+
+    auto finish = [&](size_t slot) {
+        pending &p = slots[slot];
+        ::close(p.fd);
+        p.fd = -1;
+        p.file.data.resize(p.file.opened ? p.done : 0);
+        free_slots.push_back(slot);
+        return deliver(std::move(p.file));
+    };
+
+    while (ok && (next_file < m_files.size() || free_slots.size() < slots.size())) {
+        // doplníme frontu jádra dalšími soubory
+        while (ok && next_file < m_files.size() && !free_slots.empty()) {
+            loaded_file file;
+            file.index = next_file;
+            size_t size = 0;
+            int fd = open_file(m_files[next_file], m_large_file_size, file, size);
+            ++next_file;
+            if (fd < 0) {
+                ok = deliver(std::move(file));
+                continue;
+            }
+            size_t slot = free_slots.back();
+            free_slots.pop_back();
+            slots[slot].file = std::move(file);
+            slots[slot].fd = fd;
+            slots[slot].done = 0;
+            m_ring->queue_read(fd, slots[slot].file.data.data(), size, 0, slot);
+        }
+        if (!ok || free_slots.size() == slots.size()) {
+            continue;
+        }
+        if (!m_ring->submit_and_wait(1)) {
+            failed = true;
+            break;
+        }
+        m_ring->reap([&](uint64_t slot, int res) {
+            pending &p = slots[slot];
+            const size_t size = p.file.data.size();
+            if (res == -EINTR || res == -EAGAIN) {
+                m_ring->queue_read(p.fd, p.file.data.data() + p.done, size - p.done, p.done, slot);
+                return;
+            }
+            if (res < 0) {
+                p.file.opened = false;
+            } else {
+                p.done += static_cast<size_t>(res);
+                if (res > 0 && p.done < size) {
+                    // krátké čtení, dočteme zbytek
+                    m_ring->queue_read(p.fd, p.file.data.data() + p.done, size - p.done, p.done, slot);
+                    return;
+                }
+            }
+            ok = finish(static_cast<size_t>(slot)) && ok;
+        });
+    }
+
+    // Obsazený slot má ve frontě právě jedno čtení do svého bufferu. Neodeslaná
+    // vezmeme zpět, na odeslaná počkáme; dřív se buffery nesmí uvolnit.
+    std::vector<bool> in_flight(slots.size());
+    size_t outstanding = 0;
+    for (size_t slot = 0; slot < slots.size(); ++slot) {
+        in_flight[slot] = slots[slot].fd >= 0;
+        outstanding += in_flight[slot];
+    }
+    m_ring->unqueue([&](uint64_t slot) {
+        in_flight[slot] = false;
+        --outstanding;
+    });
+    while (outstanding > 0 && m_ring->submit_and_wait(1)) {
+        m_ring->reap([&](uint64_t slot, int) {
+            in_flight[slot] = false;
+            --outstanding;
+        });
+    }
+    if (outstanding > 0) {
+        // na dokončení nejde počkat: ring zrušíme a buffery, do kterých jádro
+        // ještě může zapisovat, úmyslně necháme alokované
+        m_ring->close();
+        for (size_t slot = 0; slot < slots.size(); ++slot) {
+            if (in_flight[slot]) {
+                new std::vector<char>(std::move(slots[slot].file.data));
+            }
+        }
+    }
+    std::vector<size_t> unfinished;
+    for (auto &p : slots) {
+        if (p.fd >= 0) {
+            ::close(p.fd);
+            p.fd = -1;
+            unfinished.push_back(p.file.index);
+        }
+    }
+    if (failed) {
+        // io_uring selhal natrvalo: rozpracované a zbylé soubory načteme synchronně
+        for (; next_file < m_files.size(); ++next_file) {
+            unfinished.push_back(next_file);
+        }
+        for (size_t index : unfinished) {
+            loaded_file file;
+            file.index = index;
+            load_file(m_files[index], m_large_file_size, file);
+            if (!deliver(std::move(file))) {
+                break;
+            }
+        }
+    }
+#endif
+    producer_finished();
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class read_backend {
+    automatic, //!< io_uring, pokud ho jádro podporuje, jinak vlákna
+    threads,   //!< vlákna s blokujícím čtením
+};
+
+//! Převede jméno (auto, threads) na read_backend. Vrací false pro neznámé jméno.
+bool parse_read_backend(const std::string &name, read_backend &backend);
+
+//! Obsah jednoho načteného souboru.
+struct loaded_file {
+    size_t index = 0;    //!< pořadí souboru v seznamu
+    bool opened = false; //!< false, pokud soubor nešel otevřít nebo přečíst
+    bool large = false;  //!< soubor je větší než limit a nenačítal se
+    std::vector<char> data;
+};
+
+/**
+ * Asynchronní načítání mnoha malých souborů.
+ *
+ * Soubory se čtou celé do paměti, v pořadí seznamu, ale mnoho najednou:
+ * přes io_uring (jedno vlákno drží ve frontě jádra až `in_flight` čtení)
+ * nebo, kde io_uring není, přes několik vláken s blokujícím čtením.
+ * Načtené soubory si odebírá libovolný počet vláken přes next() v pořadí
+ * dokončení. Soubory větší než `large_file_size` se nenačítají a vrací se
+ * s příznakem `large`, aby je volající mohl zpracovat po úsecích přes mmap.
+ *
+ * Načtené a neodebrané soubory se drží nejvýše v počtu `in_flight`,
+ * takže paměť je omezená na zhruba 2 * in_flight * large_file_size.
+ */
+class async_file_reader {
+public:
+    async_file_reader(const std::vector<std::string> &files, read_backend backend = read_backend::automatic,
+                      size_t in_flight = 32, size_t large_file_size = 1 << 20);
+
+    //! Zastaví čtení a počká na všechna vlákna.
+    ~async_file_reader();
+
+    async_file_reader(const async_file_reader &) = delete;
+
+    async_file_reader &operator=(const async_file_reader &) = delete;
+
+    /**
+     * Počká na další načtený soubor a uloží ho do `file`. Vrací false, když
+     * už byly odebrány všechny. Smí se volat z více vláken najednou.
+     */
+    bool next(loaded_file &file);
+
+    //! Jméno použitého způsobu čtení ("io_uring" nebo "threads").
+    const char *backend_name() const;
+
+private:
+    //! Kruhové fronty io_uring (definované jen na Linuxu).
+    struct ring;
+
+    //! Předá načtený soubor odběratelům; false, pokud se čtení zastavuje.
+    bool deliver(loaded_file &&file);
+
+    void producer_finished();
+
+    void run_threads();
+
+    void run_io_uring();
+
+    const std::vector<std::string> &m_files;
+    size_t m_in_flight;
+    size_t m_large_file_size;
+    std::unique_ptr<ring> m_ring;
+
+    std::atomic<size_t> m_next_file{0};
+    std::mutex m_mutex;
+    std::condition_variable m_changed;
+    std::deque<loaded_file> m_ready;
+    size_t m_running_producers = 0;
+    bool m_stop = false;
+
+    std::vector<std::thread> m_threads;
+};
@@ -0,0 +1,183 @@
+#include "corpus.hpp"
+#include "../counter.hpp"
+#include "../output.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define BENCH_HAVE_FORK 1
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+/*
+    Benchmark celého počítání na vygenerovaných korpusech.
+
+    Pro každý korpus měří zvlášť fázi počítání (count_words_in_file) a fázi
+    výstupu (seřazení a zápis do /dev/null přes output_writer) a vypisuje
+    slova/s, MB/s a špičkové RSS. Na Linuxu se špička před každou fází
+    vynuluje, takže jde o špičku dané fáze (včetně paměti, která z předchozí
+    fáze zůstala, např. tabulky slov); jinde je to kumulativní špička
+    procesu a výpis to tak označí. Na POSIX systémech běží každý korpus
+    v samostatném procesu, aby se špičková paměť jednotlivých případů
+    neovlivňovala.
+
+    Použití: bench-wc [velikost korpusu v MB] [počet vláken]
+*/
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+    struct bench_case {
+        const char *name;
+        corpus_options options;
+    };
+
+    std::vector<bench_case> make_cases(size_t bytes) {
+        std::vector<bench_case> cases;
+        corpus_options base;
+        base.bytes = bytes;
+
+        cases.push_back({"zipf-10k", base});
+        cases.back().options.vocabulary = 10000;
+
+        cases.push_back({"zipf-1M", base});
+        cases.back().options.vocabulary = 1000000;
+
+        cases.push_back({"uniform-100k", base});
+        cases.back().options.zipf_exponent = 0.0;
+
+        cases.push_back({"long-lines", base});
+        cases.back().options.min_line_words = 200;
+        cases.back().options.max_line_words = 2000;
+
+        cases.push_back({"punctuation-heavy", base});
+        cases.back().options.punctuation = 0.8;
+        return cases;
+    }
+
+    /**
+     * Vynuluje špičkové RSS procesu, aby další peak_rss_mb() platilo jen pro
+     * následující fázi. Umí to jen Linux (zápis 5 do /proc/self/clear_refs);
+     * jinde vrací false a špička zůstává kumulativní za celý proces.
+     */
+    bool reset_peak_rss() {
+#if defined(__linux__)
+        std::ofstream clear_refs("/proc/self/clear_refs");
+        clear_refs << "5";
+        clear_refs.close();
+        return !clear_refs.fail();
+#else
+        return false;
+#endif
+    }
+
+    //! Špičkové RSS procesu v MB od startu nebo od posledního reset_peak_rss(), -1 pokud ho neumíme zjistit.
+    double peak_rss_mb() {
+#if defined(__linux__)
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.compare(0, 6, "VmHWM:") == 0) {
+                return std::stod(line.substr(6)) / 1024;
+            }
+        }
+#endif
+#ifdef BENCH_HAVE_FORK
+        struct rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+        return static_cast<double>(usage.ru_maxrss) / (1 << 20);
+#else
+        return static_cast<double>(usage.ru_maxrss) / 1024;
+#endif
+#else
+        return -1;
+#endif
+    }
+
+    void print_phase(const char *phase, double seconds, size_t words, size_t bytes, bool phase_peak) {
+        std::printf("  %-6s %8.3f s %10.2f Mwords/s %10.2f MB/s   %s %8.1f MB\n", phase, seconds,
+                    static_cast<double>(words) / seconds / 1e6,
+                    static_cast<double>(bytes) / seconds / (1 << 20),
+                    phase_peak ? "phase peak RSS" : "process peak RSS", peak_rss_mb());
+    }
+
+    void run_case(const bench_case &c, const std::string &file_name, unsigned jobs) {
+        size_t bytes = std::filesystem::file_size(file_name);
+
+        bool phase_peak = reset_peak_rss();
+        auto start = Clock::now();
+        word_table words;
+        count_words_in_file(file_name, jobs, words);
+        std::chrono::duration<double> count_time = Clock::now() - start;
+
+        size_t total = 0;
+        words.for_each([&total](std::string_view, long count) {
+            total += static_cast<size_t>(count);
+        });
+
+        std::printf("%s: %.1f MB, %zu words, %zu distinct\n", c.name,
+                    static_cast<double>(bytes) / (1 << 20), total, words.size());
+        print_phase("count", count_time.count(), total, bytes, phase_peak);
+
+#if defined(_WIN32)
+        std::FILE *null_file = std::fopen("NUL", "wb");
+#else
+        std::FILE *null_file = std::fopen("/dev/null", "wb");
+#endif
+        phase_peak = reset_peak_rss();
+        start = Clock::now();
+        {
+            output_writer out(null_file, output_format::text);
+            for (const auto &pair : words.sorted()) {
+                out.entry(pair.first, pair.second);
+            }
+        }
+        std::chrono::duration<double> output_time = Clock::now() - start;
+        std::fclose(null_file);
+        print_phase("output", output_time.count(), words.size(), bytes, phase_peak);
+        std::fflush(stdout);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    size_t megabytes = argc > 1 ? std::stoul(argv[1]) : 64;
+    unsigned jobs = argc > 2 ? static_cast<unsigned>(std::stoul(argv[2])) : std::thread::hardware_concurrency();
+    if (jobs == 0) {
+        jobs = 1;
+    }
+    auto dir = std::filesystem::temp_directory_path();
+    std::printf("corpus size %zu MB, %u threads\n\n", megabytes, jobs);
+
+    for (const auto &c : make_cases(megabytes << 20)) {
+        std::string file_name = (dir / (std::string("wc-bench-") + c.name + ".txt")).string();
+        if (!write_corpus(file_name, c.options)) {
+            std::cerr << "Could not write " << file_name << std::endl;
+            return 1;
+        }
+#ifdef BENCH_HAVE_FORK
+        std::fflush(stdout);
+        pid_t pid = fork();
+        if (pid == 0) {
+            run_case(c, file_name, jobs);
+            _exit(0);
+        }
+        int status = 0;
+        waitpid(pid, &status, 0);
+#else
+        run_case(c, file_name, jobs);
+#endif
+        std::filesystem::remove(file_name);
+        std::printf("\n");
+    }
+    return 0;
+}
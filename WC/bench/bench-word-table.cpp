@@ -0,0 +1,72 @@
+#include "corpus.hpp"
+#include "../word_table.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/*
+    Porovnání původní std::map s výjimkou pro každé nové slovo a word_table
+    se seřazením až při výpisu. Korpus je generovaný deterministicky,
+    slova se vybírají ze slovníku se Zipfovým rozdělením (viz corpus.hpp).
+*/
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+    std::vector<std::string> generate_tokens(size_t vocabulary, size_t tokens) {
+        auto words = generate_vocabulary(vocabulary, 42);
+        zipf_sampler sampler(words.size(), 1.0);
+        std::mt19937_64 gen(43);
+        std::vector<std::string> ret;
+        ret.reserve(tokens);
+        for (size_t i = 0; i < tokens; ++i) {
+            ret.push_back(words[sampler(gen)]);
+        }
+        return ret;
+    }
+
+    template <typename Fn>
+    double measure(const char *name, size_t tokens, Fn fn) {
+        auto start = Clock::now();
+        size_t distinct = fn();
+        std::chrono::duration<double> elapsed = Clock::now() - start;
+        std::cout << name << ": " << elapsed.count() << " s, "
+                  << static_cast<double>(tokens) / elapsed.count() / 1e6 << " Mwords/s, "
+                  << distinct << " distinct" << std::endl;
+        return elapsed.count();
+    }
+}
+
+int main(int argc, char *argv[]) {
+    size_t tokens = argc > 1 ? std::stoul(argv[1]) : 5'000'000;
+    size_t vocabulary = argc > 2 ? std::stoul(argv[2]) : 500'000;
+    auto corpus = generate_tokens(vocabulary, tokens);
+
+    double map_time = measure("std::map + try/catch", tokens, [&corpus]() {
+        std::map<std::string, long> words;
+        for (const auto &word : corpus) {
+            try {
+                words.at(word)++;
+            } catch (std::out_of_range &) {
+                words[word] = 1;
+            }
+        }
+        return words.size();
+    });
+
+    double table_time = measure("word_table + sorted", tokens, [&corpus]() {
+        word_table words;
+        for (const auto &word : corpus) {
+            words.add(word);
+        }
+        auto sorted = words.sorted();
+        return sorted.size();
+    });
+
+    std::cout << "speedup: " << map_time / table_time << "x" << std::endl;
+    return 0;
+}
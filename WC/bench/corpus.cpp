@@ -0,0 +1,115 @@
+#include "corpus.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <unordered_set>
+
+namespace {
+    const char punctuation_chars[] = ".,;:!?\"'()-";
+
+    // Rozdělení ze <random> se mezi standardními knihovnami liší, mt19937_64
+    // je ale definovaný přesně. Vlastní převody drží korpus stejný všude.
+
+    double uniform01(std::mt19937_64 &gen) {
+        return static_cast<double>(gen() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    size_t uniform_index(std::mt19937_64 &gen, size_t size) {
+        return static_cast<size_t>(gen() % size);
+    }
+}
+
+std::vector<std::string> generate_vocabulary(size_t size, uint64_t seed) {
+    std::mt19937_64 gen(seed);
+    std::unordered_set<std::string> seen;
+    std::vector<std::string> ret;
+    ret.reserve(size);
+    while (ret.size() < size) {
+        // krátká slova jsou častější, jako v přirozeném jazyce
+        size_t length = 1;
+        while (length < 14 && uniform01(gen) < 0.75) {
+            ++length;
+        }
+        std::string word(length, ' ');
+        for (auto &c : word) {
+            c = static_cast<char>('a' + uniform_index(gen, 26));
+        }
+        if (seen.insert(word).second) {
+            ret.push_back(std::move(word));
+        }
+    }
+    return ret;
+}
+
+zipf_sampler::zipf_sampler(size_t size, double exponent) : m_cdf(size) {
+    double sum = 0;
+    for (size_t i = 0; i < size; ++i) {
+        sum += 1.0 / std::pow(static_cast<double>(i + 1), exponent);
+        m_cdf[i] = sum;
+    }
+    for (auto &value : m_cdf) {
+        value /= sum;
+    }
+}
+
+size_t zipf_sampler::operator()(std::mt19937_64 &gen) const {
+    double u = uniform01(gen);
+    auto it = std::upper_bound(m_cdf.begin(), m_cdf.end(), u);
+    return std::min(static_cast<size_t>(it - m_cdf.begin()), m_cdf.size() - 1);
+}
+
+namespace {
+    //! Generuje korpus po částech zhruba `chunk_size` bajtů, každou předá `sink`.
+    template <typename Sink>
+    void generate_chunks(const corpus_options &options, size_t chunk_size, Sink sink) {
+        auto vocabulary = generate_vocabulary(options.vocabulary, options.seed);
+        zipf_sampler sampler(vocabulary.size(), options.zipf_exponent);
+        std::mt19937_64 gen(options.seed + 1);
+        size_t line_words_range = std::max(options.min_line_words, options.max_line_words) - options.min_line_words + 1;
+        auto has_punctuation = [&]() { return uniform01(gen) < options.punctuation; };
+        auto punctuation = [&]() { return punctuation_chars[uniform_index(gen, sizeof(punctuation_chars) - 1)]; };
+
+        std::string chunk;
+        chunk.reserve(chunk_size + 256);
+        size_t generated = 0;
+        while (generated < options.bytes) {
+            size_t words = options.min_line_words + uniform_index(gen, line_words_range);
+            for (size_t i = 0; i < words; ++i) {
+                if (i > 0) {
+                    chunk.push_back(' ');
+                }
+                if (has_punctuation()) {
+                    chunk.push_back(punctuation());
+                }
+                chunk += vocabulary[sampler(gen)];
+                if (has_punctuation()) {
+                    chunk.push_back(punctuation());
+                }
+            }
+            chunk.push_back('\n');
+            if (chunk.size() >= chunk_size || generated + chunk.size() >= options.bytes) {
+                generated += chunk.size();
+                sink(chunk);
+                chunk.clear();
+            }
+        }
+    }
+}
+
+std::string generate_corpus(const corpus_options &options) {
+    std::string ret;
+    ret.reserve(options.bytes + 256);
+    generate_chunks(options, 1 << 20, [&ret](const std::string &chunk) {
+        ret += chunk;
+    });
+    return ret;
+}
+
+bool write_corpus(const std::string &file_name, const corpus_options &options) {
+    std::ofstream out(file_name, std::ios::binary);
+    generate_chunks(options, 1 << 20, [&out](const std::string &chunk) {
+        out.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+    });
+    return static_cast<bool>(out);
+}
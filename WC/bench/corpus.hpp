@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * Parametry syntetického korpusu. Stejné parametry (včetně `seed`) dají
+ * vždy bajtově stejný korpus, nezávisle na platformě a standardní knihovně.
+ */
+struct corpus_options {
+    size_t bytes = 64 << 20;        //!< přibližná velikost korpusu
+    size_t vocabulary = 100000;     //!< počet různých slov ve slovníku
+    double zipf_exponent = 1.0;     //!< exponent Zipfova rozdělení (0 = rovnoměrné)
+    size_t min_line_words = 1;      //!< nejmenší počet slov na řádku
+    size_t max_line_words = 20;     //!< největší počet slov na řádku
+    double punctuation = 0.1;       //!< pravděpodobnost interpunkce před/za slovem
+    uint64_t seed = 42;
+};
+
+//! Slovník `size` různých náhodných slov z malých písmen (délka 1 až 14, `size` musí být dosažitelné).
+std::vector<std::string> generate_vocabulary(size_t size, uint64_t seed);
+
+/**
+ * Vybírá indexy 0..size-1 s pravděpodobností úměrnou 1 / (index + 1)^exponent.
+ */
+class zipf_sampler {
+public:
+    zipf_sampler(size_t size, double exponent);
+
+    size_t operator()(std::mt19937_64 &gen) const;
+
+private:
+    std::vector<double> m_cdf;
+};
+
+//! Vygeneruje korpus podle `options`.
+std::string generate_corpus(const corpus_options &options);
+
+//! Vygeneruje korpus rovnou do souboru (po částech, celý se nedrží v paměti). Vrací false při chybě zápisu.
+bool write_corpus(const std::string &file_name, const corpus_options &options);
@@ -0,0 +1,38 @@
+#include "corpus.hpp"
+
+#include <iostream>
+#include <string>
+
+/*
+    Vygeneruje syntetický korpus do souboru, např. pro ruční měření WC.
+
+    Použití: gen-corpus SOUBOR [MB] [velikost slovníku] [zipf exponent] [interpunkce] [seed]
+*/
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        std::cout << "usage: gen-corpus FILE [MB] [VOCABULARY] [ZIPF_EXPONENT] [PUNCTUATION] [SEED]" << std::endl;
+        return 1;
+    }
+    corpus_options options;
+    if (argc > 2) {
+        options.bytes = std::stoul(argv[2]) << 20;
+    }
+    if (argc > 3) {
+        options.vocabulary = std::stoul(argv[3]);
+    }
+    if (argc > 4) {
+        options.zipf_exponent = std::stod(argv[4]);
+    }
+    if (argc > 5) {
+        options.punctuation = std::stod(argv[5]);
+    }
+    if (argc > 6) {
+        options.seed = std::stoull(argv[6]);
+    }
+    if (!write_corpus(argv[1], options)) {
+        std::cerr << "Could not write " << argv[1] << std::endl;
+        return 1;
+    }
+    return 0;
+}
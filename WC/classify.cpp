@@ -0,0 +1,143 @@
+#include "classify.hpp"
+#include "tokenizer.hpp"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define WC_HAVE_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+block_masks classify_block_scalar(const char *p) {
+    block_masks ret;
+    for (size_t i = 0; i < classify_block_size; ++i) {
+        auto c = static_cast<unsigned char>(p[i]);
+        unsigned char cls = char_classes[c];
+        ret.separator |= static_cast<uint64_t>(cls == char_separator) << i;
+        ret.word_char |= static_cast<uint64_t>(cls == char_alnum) << i;
+        ret.upper |= static_cast<uint64_t>(c >= 'A' && c <= 'Z') << i;
+        ret.high |= static_cast<uint64_t>(c >= 0x80) << i;
+    }
+    return ret;
+}
+
+#ifdef WC_HAVE_X86_SIMD
+namespace {
+    // Bajty >= 0x80 jsou při znaménkovém porovnání záporné, takže do žádného
+    // z ASCII rozsahů nespadnou.
+
+    __attribute__((target("sse2")))
+    block_masks classify_block_sse2(const char *p) {
+        const __m128i space = _mm_set1_epi8(' ');
+        const __m128i newline = _mm_set1_epi8('\n');
+        const __m128i tab = _mm_set1_epi8('\t');
+        const __m128i digit_lo = _mm_set1_epi8('0' - 1);
+        const __m128i digit_hi = _mm_set1_epi8('9' + 1);
+        const __m128i alpha_lo = _mm_set1_epi8('a' - 1);
+        const __m128i alpha_hi = _mm_set1_epi8('z' + 1);
+        const __m128i case_bit = _mm_set1_epi8(0x20);
+        const __m128i upper_lo = _mm_set1_epi8('A' - 1);
+        const __m128i upper_hi = _mm_set1_epi8('Z' + 1);
+        block_masks ret;
+        for (size_t i = 0; i < classify_block_size; i += 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+            __m128i sep = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, space), _mm_cmpeq_epi8(v, newline)),
+                                       _mm_cmpeq_epi8(v, tab));
+            __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, digit_lo), _mm_cmpgt_epi8(digit_hi, v));
+            __m128i lower = _mm_or_si128(v, case_bit);
+            __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, alpha_lo), _mm_cmpgt_epi8(alpha_hi, lower));
+            auto sep_bits = static_cast<uint32_t>(_mm_movemask_epi8(sep));
+            auto word_bits = static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(digit, alpha)));
+            __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(v, upper_lo), _mm_cmpgt_epi8(upper_hi, v));
+            auto upper_bits = static_cast<uint32_t>(_mm_movemask_epi8(upper));
+            auto high_bits = static_cast<uint32_t>(_mm_movemask_epi8(v));
+            ret.separator |= static_cast<uint64_t>(sep_bits) << i;
+            ret.word_char |= static_cast<uint64_t>(word_bits) << i;
+            ret.upper |= static_cast<uint64_t>(upper_bits) << i;
+            ret.high |= static_cast<uint64_t>(high_bits) << i;
+        }
+        return ret;
+    }
+
+    __attribute__((target("avx2")))
+    block_masks classify_block_avx2(const char *p) {
+        const __m256i space = _mm256_set1_epi8(' ');
+        const __m256i newline = _mm256_set1_epi8('\n');
+        const __m256i tab = _mm256_set1_epi8('\t');
+        const __m256i digit_lo = _mm256_set1_epi8('0' - 1);
+        const __m256i digit_hi = _mm256_set1_epi8('9' + 1);
+        const __m256i alpha_lo = _mm256_set1_epi8('a' - 1);
+        const __m256i alpha_hi = _mm256_set1_epi8('z' + 1);
+        const __m256i case_bit = _mm256_set1_epi8(0x20);
+        const __m256i upper_lo = _mm256_set1_epi8('A' - 1);
+        const __m256i upper_hi = _mm256_set1_epi8('Z' + 1);
+        block_masks ret;
+        for (size_t i = 0; i < classify_block_size; i += 32) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+            __m256i sep = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, space), _mm256_cmpeq_epi8(v, newline)),
+                                          _mm256_cmpeq_epi8(v, tab));
+            __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(v, digit_lo), _mm256_cmpgt_epi8(digit_hi, v));
+            __m256i lower = _mm256_or_si256(v, case_bit);
+            __m256i alpha = _mm256_and_si256(_mm256_cmpgt_epi8(lower, alpha_lo), _mm256_cmpgt_epi8(alpha_hi, lower));
+            auto sep_bits = static_cast<uint32_t>(_mm256_movemask_epi8(sep));
+            auto word_bits = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(digit, alpha)));
+            __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(v, upper_lo), _mm256_cmpgt_epi8(upper_hi, v));
+            auto upper_bits = static_cast<uint32_t>(_mm256_movemask_epi8(upper));
+            auto high_bits = static_cast<uint32_t>(_mm256_movemask_epi8(v));
+            ret.separator |= static_cast<uint64_t>(sep_bits) << i;
+            ret.word_char |= static_cast<uint64_t>(word_bits) << i;
+            ret.upper |= static_cast<uint64_t>(upper_bits) << i;
+            ret.high |= static_cast<uint64_t>(high_bits) << i;
+        }
+        return ret;
+    }
+}
+#endif
+
+namespace {
+    using classify_fn = block_masks (*)(const char *);
+
+    struct classifier {
+        classify_fn fn = classify_block_scalar;
+        const char *name = "scalar";
+
+        classifier() {
+#ifdef WC_HAVE_X86_SIMD
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) {
+                fn = classify_block_avx2;
+                name = "avx2";
+            } else if (__builtin_cpu_supports("sse2")) {
+                fn = classify_block_sse2;
+                name = "sse2";
+            }
+#endif
+        }
+    };
+
+    const classifier &selected_classifier() {
+        static const classifier selected;
+        return selected;
+    }
+}
+
+block_masks classify_block(const char *p) {
+    static const classify_fn fn = selected_classifier().fn;
+    return fn(p);
+}
+
+const char *classifier_name() {
+    return selected_classifier().name;
+}
+
+std::vector<classifier_variant> classifier_variants() {
+    std::vector<classifier_variant> ret{{"scalar", classify_block_scalar}};
+#ifdef WC_HAVE_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) {
+        ret.push_back({"sse2", classify_block_sse2});
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        ret.push_back({"avx2", classify_block_avx2});
+    }
+#endif
+    return ret;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+//! Počet bajtů, které classify_block zpracuje najednou.
+static const size_t classify_block_size = 64;
+
+/**
+ * Bitové masky pro jeden blok 64 bajtů, bit i odpovídá bajtu i.
+ */
+struct block_masks {
+    uint64_t separator = 0; //!< mezera, nový řádek nebo tabulátor
+    uint64_t word_char = 0; //!< alfanumerický ASCII znak
+    uint64_t upper = 0;     //!< velké písmeno A-Z
+    uint64_t high = 0;      //!< bajt >= 0x80, tj. část vícebajtového znaku UTF-8
+};
+
+/**
+ * Klasifikuje 64 bajtů od `p`.
+ *
+ * Implementace (AVX2, SSE2 nebo skalární) se vybere jednou za běhu podle
+ * toho, co podporuje procesor.
+ */
+block_masks classify_block(const char *p);
+
+//! Skalární implementace, kterou lze použít pro porovnání s vektorovými.
+block_masks classify_block_scalar(const char *p);
+
+//! Název implementace, kterou používá classify_block.
+const char *classifier_name();
+
+/**
+ * Jedna implementace klasifikace bloku.
+ */
+struct classifier_variant {
+    const char *name;
+    block_masks (*fn)(const char *p);
+};
+
+/**
+ * Všechny implementace, které lze na tomto procesoru spustit, skalární je
+ * vždy první. Slouží k ověření, že vektorové dávají stejné masky.
+ */
+std::vector<classifier_variant> classifier_variants();
+
+//! Index nejnižšího nastaveného bitu, `mask` nesmí být 0.
+inline unsigned lowest_bit(uint64_t mask) {
+#if defined(_MSC_VER)
+    unsigned long ret;
+    _BitScanForward64(&ret, mask);
+    return static_cast<unsigned>(ret);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+}
+
+//! Index nejvyššího nastaveného bitu, `mask` nesmí být 0.
+inline unsigned highest_bit(uint64_t mask) {
+#if defined(_MSC_VER)
+    unsigned long ret;
+    _BitScanReverse64(&ret, mask);
+    return static_cast<unsigned>(ret);
+#else
+    return 63 - static_cast<unsigned>(__builtin_clzll(mask));
+#endif
+}
@@ -0,0 +1,190 @@
+#include "count_index.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+namespace {
+    const char index_magic[] = "WCI1";
+    const size_t header_size = 24;
+    const size_t record_size = 24;
+
+    uint64_t read_u64(const char *p) {
+        uint64_t ret = 0;
+        for (size_t i = 0; i < 8; ++i) {
+            ret |= static_cast<uint64_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+        }
+        return ret;
+    }
+
+    uint32_t read_u32(const char *p) {
+        return static_cast<uint32_t>(read_u64(p) & 0xffffffffu);
+    }
+
+    void put_u64(char *p, uint64_t value) {
+        for (size_t i = 0; i < 8; ++i) {
+            p[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+        }
+    }
+
+    void put_u32(char *p, uint32_t value) {
+        for (size_t i = 0; i < 4; ++i) {
+            p[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+        }
+    }
+
+    /**
+     * Zapíše index ze seřazené posloupnosti. `visit(fn)` musí zavolat
+     * fn(word, count) pro všechna slova ve vzestupném pořadí a musí jít
+     * zavolat opakovaně; posloupnost se projde třikrát (velikosti, záznamy,
+     * řetězce), takže se nikdy nedrží celá v paměti.
+     */
+    template <typename Visit>
+    bool write_entries(const std::string &file_name, Visit visit) {
+        uint64_t entries = 0;
+        uint64_t strings_size = 0;
+        visit([&](std::string_view word, long) {
+            ++entries;
+            strings_size += word.size();
+        });
+
+        std::FILE *file = std::fopen(file_name.c_str(), "wb");
+        if (!file) {
+            return false;
+        }
+        std::vector<char> io_buffer(1 << 20);
+        std::setvbuf(file, io_buffer.data(), _IOFBF, io_buffer.size());
+
+        char header[header_size] = {};
+        std::memcpy(header, index_magic, 4);
+        put_u64(header + 8, entries);
+        put_u64(header + 16, strings_size);
+        std::fwrite(header, 1, header_size, file);
+
+        uint64_t offset = 0;
+        visit([&](std::string_view word, long count) {
+            char record[record_size] = {};
+            put_u64(record, offset);
+            put_u32(record + 8, static_cast<uint32_t>(word.size()));
+            put_u64(record + 16, static_cast<uint64_t>(count));
+            std::fwrite(record, 1, record_size, file);
+            offset += word.size();
+        });
+        visit([&](std::string_view word, long) {
+            std::fwrite(word.data(), 1, word.size(), file);
+        });
+
+        bool ok = !std::ferror(file);
+        ok = std::fclose(file) == 0 && ok;
+        return ok;
+    }
+}
+
+count_index::count_index(const std::string &file_name) : m_file(file_name) {
+    if (!m_file.is_open() || m_file.size() < header_size ||
+        std::memcmp(m_file.data(), index_magic, 4) != 0) {
+        return;
+    }
+    uint64_t entries = read_u64(m_file.data() + 8);
+    uint64_t strings_size = read_u64(m_file.data() + 16);
+    // velikosti oddílů musí přesně odpovídat souboru (odečítáme, aby součet nepřetekl)
+    if (entries > (m_file.size() - header_size) / record_size ||
+        strings_size != m_file.size() - header_size - entries * record_size) {
+        return;
+    }
+    const char *records = m_file.data() + header_size;
+    for (uint64_t i = 0; i < entries; ++i) {
+        // každé slovo musí ležet celé v oddílu řetězců, jinak by word() četl mimo soubor
+        uint64_t offset = read_u64(records + i * record_size);
+        uint64_t length = read_u32(records + i * record_size + 8);
+        if (offset > strings_size || length > strings_size - offset) {
+            return;
+        }
+    }
+    m_size = static_cast<size_t>(entries);
+    m_records = records;
+    m_strings = m_records + m_size * record_size;
+    m_valid = true;
+}
+
+bool count_index::exists() const {
+    return m_file.is_open() && m_file.size() > 0;
+}
+
+bool count_index::is_valid() const {
+    return m_valid;
+}
+
+size_t count_index::size() const {
+    return m_size;
+}
+
+std::string_view count_index::word(size_t i) const {
+    const char *record = m_records + i * record_size;
+    return std::string_view(m_strings + read_u64(record), read_u32(record + 8));
+}
+
+long count_index::count(size_t i) const {
+    return static_cast<long>(read_u64(m_records + i * record_size + 16));
+}
+
+long count_index::find(std::string_view word) const {
+    size_t lo = 0;
+    size_t hi = m_size;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        auto current = this->word(mid);
+        if (current < word) {
+            lo = mid + 1;
+        } else if (word < current) {
+            hi = mid;
+        } else {
+            return count(mid);
+        }
+    }
+    return 0;
+}
+
+bool write_index(const std::string &file_name, const std::vector<word_table::value_type> &sorted) {
+    return write_entries(file_name, [&sorted](auto &&fn) {
+        for (const auto &pair : sorted) {
+            fn(pair.first, pair.second);
+        }
+    });
+}
+
+bool merge_into_index(const std::string &file_name, const word_table &words) {
+    auto fresh = words.sorted();
+    std::string tmp_name = file_name + ".tmp";
+    bool ok;
+    {
+        count_index old(file_name);
+        if (old.exists() && !old.is_valid()) {
+            return false;
+        }
+        ok = write_entries(tmp_name, [&old, &fresh](auto &&fn) {
+            size_t i = 0;
+            size_t j = 0;
+            while (i < old.size() || j < fresh.size()) {
+                if (j == fresh.size() || (i < old.size() && old.word(i) < fresh[j].first)) {
+                    fn(old.word(i), old.count(i));
+                    ++i;
+                } else if (i == old.size() || fresh[j].first < old.word(i)) {
+                    fn(fresh[j].first, fresh[j].second);
+                    ++j;
+                } else {
+                    fn(fresh[j].first, old.count(i) + fresh[j].second);
+                    ++i;
+                    ++j;
+                }
+            }
+        });
+    }
+    if (!ok) {
+        std::remove(tmp_name.c_str());
+        return false;
+    }
+#if defined(_WIN32)
+    std::remove(file_name.c_str());
+#endif
+    return std::rename(tmp_name.c_str(), file_name.c_str()) == 0;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "mapped_file.hpp"
+#include "word_table.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * Index četností slov uložený na disku.
+ *
+ * Formát (little-endian):
+ *   hlavička:  "WCI1", u32 rezervováno, u64 počet slov N, u64 délka řetězců S
+ *   záznamy:   N × { u64 offset slova v řetězcích, u32 délka, u32 rezervováno, i64 počet }
+ *   řetězce:   S bajtů, slova za sebou bez oddělovačů
+ *
+ * Záznamy jsou seřazené podle slova, takže index jde namapovat do paměti
+ * a hledat v něm binárně bez načítání, a dva indexy jdou sloučit jedním
+ * lineárním průchodem.
+ */
+class count_index {
+public:
+    explicit count_index(const std::string &file_name);
+
+    /**
+     * Vrací true, pokud soubor existuje a není prázdný (i když nemusí být
+     * platný index). Prázdný soubor po `touch` nebo po přerušeném prvním
+     * zápisu se bere jako neexistující index.
+     */
+    bool exists() const;
+
+    /**
+     * Vrací true, pokud soubor existuje, má platnou hlavičku, velikosti oddílů
+     * odpovídají velikosti souboru a všechna slova leží v oddílu řetězců.
+     */
+    bool is_valid() const;
+
+    //! Počet slov v indexu.
+    size_t size() const;
+
+    std::string_view word(size_t i) const;
+
+    long count(size_t i) const;
+
+    //! Počet výskytů slova, 0 pokud v indexu není.
+    long find(std::string_view word) const;
+
+private:
+    mapped_file m_file;
+    bool m_valid = false;
+    size_t m_size = 0;
+    const char *m_records = nullptr;
+    const char *m_strings = nullptr;
+};
+
+//! Zapíše seřazená slova do nového indexu `file_name`. Vrací false při chybě zápisu.
+bool write_index(const std::string &file_name, const std::vector<word_table::value_type> &sorted);
+
+/**
+ * Přičte slova z `words` do existujícího indexu `file_name` (pokud neexistuje
+ * nebo je prázdný, vytvoří ho). Starý index se čte jen sekvenčně, nový se zapíše vedle
+ * a teprve pak přejmenuje, takže při chybě zůstane starý index nedotčený.
+ */
+bool merge_into_index(const std::string &file_name, const word_table &words);
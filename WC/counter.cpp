@@ -0,0 +1,260 @@
+#include "counter.hpp"
+#include "decompress.hpp"
+#include "mapped_file.hpp"
+#include "stream.hpp"
+#include "tokenizer.hpp"
+#include "work_pool.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+    //! Menší úseky se nevyplatí dávat samostatnému vláknu.
+    const size_t min_chunk_size = 1 << 20;
+
+    //! Při měření se slova tokenizují a vkládají po dávkách, aby šly obě fáze změřit zvlášť.
+    const size_t measured_batch_words = 4096;
+
+    //! Soubory větší než tohle se nenačítají celé, ale mapují se a počítají po úsecích.
+    const size_t small_file_size = 1 << 20;
+
+    //! Velikost úseku velkého souboru, který si může vzít jiné vlákno.
+    const size_t large_chunk_size = 8 << 20;
+
+    //! Kolik souborů na jedno počítací vlákno se čte dopředu.
+    const size_t reads_per_job = 8;
+
+    void count_words_measured(const char *begin, const char *end, word_table &words,
+                              const tokenizer_options &options, run_stats &stats) {
+        tokenizer tokens(begin, end, options);
+        std::vector<std::string_view> batch;
+        // převedená slova ukazují do bufferu tokenizéru, který se dalším slovem přepíše
+        std::vector<std::string> copies;
+        batch.reserve(measured_batch_words);
+        copies.reserve(measured_batch_words);
+        bool more = true;
+        while (more) {
+            batch.clear();
+            copies.clear();
+            {
+                phase_timer timer(&stats, phase::tokenize);
+                std::string_view word;
+                while (batch.size() < measured_batch_words && (more = tokens.next(word))) {
+                    if (word.data() < begin || word.data() >= end) {
+                        copies.emplace_back(word);
+                        word = copies.back();
+                    }
+                    batch.push_back(word);
+                }
+            }
+            phase_timer timer(&stats, phase::count);
+            for (auto word : batch) {
+                words.add(word);
+            }
+            stats.words += batch.size();
+        }
+    }
+}
+
+std::vector<std::pair<const char *, const char *>>
+split_chunks(const char *begin, const char *end, unsigned parts) {
+    std::vector<std::pair<const char *, const char *>> chunks;
+    size_t size = static_cast<size_t>(end - begin);
+    size_t max_parts = size / min_chunk_size + 1;
+    if (parts > max_parts) {
+        parts = static_cast<unsigned>(max_parts);
+    }
+    const char *chunk_begin = begin;
+    for (unsigned i = 1; i < parts && chunk_begin < end; ++i) {
+        const char *chunk_end = begin + size / parts * i;
+        if (chunk_end < chunk_begin) {
+            chunk_end = chunk_begin;
+        }
+        while (chunk_end < end && !is_separator(*chunk_end)) {
+            ++chunk_end;
+        }
+        chunks.emplace_back(chunk_begin, chunk_end);
+        chunk_begin = chunk_end;
+    }
+    if (chunk_begin < end) {
+        chunks.emplace_back(chunk_begin, end);
+    }
+    return chunks;
+}
+
+std::shared_ptr<chunked_file> split_file(const std::string &file_name, size_t chunk_size, run_stats *stats) {
+    phase_timer read_timer(stats, phase::read);
+    auto job = std::make_shared<chunked_file>(file_name);
+    if (!job->file.is_open()) {
+        return nullptr;
+    }
+    if (stats) {
+        job->file.prefault();
+        stats->bytes_read += job->file.size();
+    }
+    read_timer.stop();
+    const char *begin = job->file.data();
+    job->chunks = split_chunks(begin, begin + job->file.size(),
+                               static_cast<unsigned>(job->file.size() / std::max<size_t>(chunk_size, 1) + 1));
+    job->remaining = job->chunks.size();
+    return job;
+}
+
+void count_words_in_range(const char *begin, const char *end, word_table &words,
+                          const tokenizer_options &options, run_stats *stats) {
+    if (stats) {
+        count_words_measured(begin, end, words, options, *stats);
+        return;
+    }
+    tokenizer tokens(begin, end, options);
+    std::string_view word;
+    while (tokens.next(word)) {
+        words.add(word);
+    }
+}
+
+bool count_words_in_file(const std::string &file_name, unsigned jobs, word_table &words,
+                         const tokenizer_options &options, run_stats *stats) {
+    if (compression_of(file_name) != compression::none) {
+        // rozbalené bloky počítáme na tomto vlákně, souběžně s rozbalováním dalších
+        size_t total_bytes = 0;
+        bool ok = read_in_blocks(file_name, [&](const char *begin, const char *end, size_t total) {
+            count_words_in_range(begin, end, words, options, stats);
+            total_bytes = total;
+        });
+        if (stats) {
+            stats->bytes_read += total_bytes;
+        }
+        return ok;
+    }
+
+    phase_timer read_timer(stats, phase::read);
+    mapped_file file(file_name);
+    if (!file.is_open()) {
+        return false;
+    }
+    if (stats) {
+        file.prefault();
+        stats->bytes_read += file.size();
+    }
+    read_timer.stop();
+
+    auto chunks = split_chunks(file.data(), file.data() + file.size(), jobs == 0 ? 1 : jobs);
+    if (chunks.size() <= 1) {
+        for (const auto &chunk : chunks) {
+            count_words_in_range(chunk.first, chunk.second, words, options, stats);
+        }
+        return true;
+    }
+
+    std::vector<word_table> local_tables(chunks.size());
+    std::vector<run_stats> local_stats(chunks.size());
+    std::vector<std::thread> workers;
+    workers.reserve(chunks.size() - 1);
+    for (size_t i = 1; i < chunks.size(); ++i) {
+        workers.emplace_back(count_words_in_range, chunks[i].first, chunks[i].second, std::ref(local_tables[i]),
+                             std::cref(options), stats ? &local_stats[i] : nullptr);
+    }
+    count_words_in_range(chunks[0].first, chunks[0].second, local_tables[0], options, stats);
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    phase_timer merge_timer(stats, phase::merge);
+    for (const auto &local : local_tables) {
+        words.merge(local);
+    }
+    merge_timer.stop();
+    if (stats) {
+        for (const auto &local : local_stats) {
+            stats->merge(local);
+        }
+    }
+    return true;
+}
+
+std::vector<size_t> count_words_in_files(const std::vector<std::string> &files, unsigned jobs, word_table &words,
+                                         const tokenizer_options &options, read_backend backend, run_stats *stats) {
+    jobs = std::max(1u, jobs);
+    std::vector<size_t> plain;
+    std::vector<std::string> plain_names;
+    std::vector<size_t> compressed;
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (compression_of(files[i]) != compression::none) {
+            compressed.push_back(i);
+        } else {
+            plain.push_back(i);
+            plain_names.push_back(files[i]);
+        }
+    }
+
+    std::vector<word_table> local_tables(jobs);
+    std::vector<run_stats> local_stats(jobs);
+    auto local_stats_of = [&](size_t worker) { return stats ? &local_stats[worker] : nullptr; };
+    std::vector<size_t> failed;
+    std::mutex failed_mutex;
+    auto fail = [&](size_t index) {
+        std::lock_guard<std::mutex> lock(failed_mutex);
+        failed.push_back(index);
+    };
+
+    async_file_reader reader(plain_names, backend, std::max<size_t>(jobs * reads_per_job, 32), small_file_size);
+    work_stealing_pool pool(jobs, [&](size_t worker) {
+        run_stats *local = local_stats_of(worker);
+        loaded_file file;
+        phase_timer read_timer(local, phase::read);
+        if (!reader.next(file)) {
+            return work_stealing_pool::feed_result::exhausted;
+        }
+        read_timer.stop();
+        const size_t index = plain[file.index];
+        if (!file.opened) {
+            fail(index);
+        } else if (file.large) {
+            auto job = split_file(files[index], large_chunk_size, local);
+            if (!job) {
+                fail(index);
+            }
+            // úseky jdou do vlastní fronty, odkud si je mohou ukrást nečinná vlákna
+            for (size_t i = 0; job && i < job->chunks.size(); ++i) {
+                pool.push(worker, [&, job, i](size_t w) {
+                    count_words_in_range(job->chunks[i].first, job->chunks[i].second, local_tables[w], options,
+                                         local_stats_of(w));
+                });
+            }
+        } else {
+            if (local) {
+                local->bytes_read += file.data.size();
+            }
+            count_words_in_range(file.data.data(), file.data.data() + file.data.size(), local_tables[worker],
+                                 options, local);
+        }
+        return work_stealing_pool::feed_result::worked;
+    });
+    for (size_t i = 0; i < compressed.size(); ++i) {
+        pool.push(i, [&, index = compressed[i]](size_t w) {
+            if (!count_words_in_file(files[index], 1, local_tables[w], options, local_stats_of(w))) {
+                fail(index);
+            }
+        });
+    }
+    pool.start();
+    pool.wait();
+
+    phase_timer merge_timer(stats, phase::merge);
+    for (const auto &local : local_tables) {
+        words.merge(local);
+    }
+    merge_timer.stop();
+    if (stats) {
+        for (const auto &local : local_stats) {
+            stats->merge(local);
+        }
+    }
+    std::sort(failed.begin(), failed.end());
+    return failed;
+}
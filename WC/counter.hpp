@@ -0,0 +1,83 @@
+#pragma once
+
+#include "async_read.hpp"
+#include "mapped_file.hpp"
+#include "stats.hpp"
+#include "tokenizer.hpp"
+#include "word_table.hpp"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Rozdělí blok [begin, end) na nejvýše `parts` přibližně stejných úseků
+ * (úseky menší než 1 MB se nevytváří). Každá hranice se posune dopředu
+ * na nejbližší oddělovač, aby se žádné slovo nerozdělilo.
+ */
+std::vector<std::pair<const char *, const char *>>
+split_chunks(const char *begin, const char *end, unsigned parts);
+
+//! Namapovaný soubor rozdělený na úseky, které se počítají souběžně.
+struct chunked_file {
+    explicit chunked_file(const std::string &file_name) : file(file_name) {}
+
+    mapped_file file;
+    std::vector<std::pair<const char *, const char *>> chunks;
+    std::atomic<size_t> remaining{0}; //!< kolik úseků ještě není spočítaných
+};
+
+/**
+ * Namapuje soubor `file_name` a rozdělí ho (split_chunks) na úseky po
+ * zhruba `chunk_size` bajtech. Vrací nullptr, pokud soubor nešel otevřít.
+ * S `stats` se soubor hned celý načte a započítá do přečtených bajtů a fáze
+ * čtení.
+ */
+std::shared_ptr<chunked_file> split_file(const std::string &file_name, size_t chunk_size = 8 << 20,
+                                         run_stats *stats = nullptr);
+
+/**
+ * Spočítá slova v úseku [begin, end) a přičte je do `words`. S `stats`
+ * se navíc měří počet slov a zvlášť doba tokenizace a vkládání.
+ */
+void count_words_in_range(const char *begin, const char *end, word_table &words,
+                          const tokenizer_options &options = tokenizer_options(), run_stats *stats = nullptr);
+
+/**
+ * Spočítá slova v souboru `file_name` a přičte je do `words`.
+ *
+ * Soubor se namapuje do paměti a rozdělí na nejvýše `jobs` úseků tak, aby
+ * hranice padaly na bílé znaky. Každý úsek zpracuje samostatné vlákno do své
+ * lokální tabulky a lokální tabulky se nakonec sloučí do `words`.
+ *
+ * Soubory .gz a .zst se místo mapování rozbalují na vlastním vlákně a bloky
+ * se počítají na volajícím vlákně souběžně s rozbalováním (`jobs` se pak
+ * neuplatní).
+ *
+ * S `stats` se měří i jednotlivé fáze; soubor se pak před počítáním celý
+ * načte (prefault), aby se čas čtení z disku nepřipsal tokenizaci.
+ *
+ * Vrací false, pokud soubor nešel otevřít.
+ */
+bool count_words_in_file(const std::string &file_name, unsigned jobs, word_table &words,
+                         const tokenizer_options &options = tokenizer_options(), run_stats *stats = nullptr);
+
+/**
+ * Spočítá slova ve všech souborech `files` a přičte je do `words`.
+ *
+ * Soubory se rozdělují mezi `jobs` vláken s kradením práce
+ * (work_stealing_pool), každé vlákno počítá do své lokální tabulky. Malé
+ * soubory (do 1 MB) se načítají asynchronně (async_file_reader, podle
+ * `backend` přes io_uring nebo vlákna) a každý spočítá jedno vlákno. Větší
+ * soubory se namapují a rozdělí na úseky po 8 MB, které si rozeberou
+ * vlákna, jež zrovna nemají jinou práci, takže jeden obrovský soubor mezi
+ * mnoha malými nenechá ostatní jádra čekat. Komprimované soubory počítá
+ * vždy jedno vlákno celé.
+ *
+ * Vrací vzestupně seřazené indexy souborů, které nešly otevřít.
+ */
+std::vector<size_t> count_words_in_files(const std::vector<std::string> &files, unsigned jobs, word_table &words,
+                                         const tokenizer_options &options = tokenizer_options(),
+                                         read_backend backend = read_backend::automatic, run_stats *stats = nullptr);
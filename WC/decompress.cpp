@@ -0,0 +1,297 @@
+#include "decompress.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+#ifdef WC_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef WC_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+    const size_t input_block_size = 1 << 20;
+    const size_t output_block_size = 1 << 20;
+    //! Kolik rozbalených bloků smí čekat ve frontě na počítání.
+    const size_t queue_depth = 4;
+
+    //! Chyby posledního rozbalení podle jména souboru (soubory se rozbalují na více vláknech).
+    std::mutex errors_mutex;
+    std::map<std::string, std::string> errors;
+
+    bool ends_with(const std::string &str, const char *suffix) {
+        size_t length = std::strlen(suffix);
+        return str.size() > length && str.compare(str.size() - length, length, suffix) == 0;
+    }
+}
+
+compression compression_of(const std::string &file_name) {
+    if (ends_with(file_name, ".gz")) {
+        return compression::gzip;
+    }
+    if (ends_with(file_name, ".zst")) {
+        return compression::zstd;
+    }
+    return compression::none;
+}
+
+bool compression_supported(compression kind) {
+    switch (kind) {
+        case compression::none:
+            return true;
+        case compression::gzip:
+#ifdef WC_HAVE_ZLIB
+            return true;
+#else
+            return false;
+#endif
+        case compression::zstd:
+#ifdef WC_HAVE_ZSTD
+            return true;
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+std::string decompression_error(const std::string &file_name) {
+    std::lock_guard<std::mutex> lock(errors_mutex);
+    auto it = errors.find(file_name);
+    return it == errors.end() ? std::string() : it->second;
+}
+
+decompressing_reader::decompressing_reader(const std::string &file_name, compression kind)
+        : m_file_name(file_name), m_kind(kind) {
+    if (kind == compression::none || !compression_supported(kind)) {
+        return;
+    }
+    m_file = std::fopen(file_name.c_str(), "rb");
+    if (m_file) {
+        m_thread = std::thread(&decompressing_reader::run, this);
+    }
+}
+
+decompressing_reader::~decompressing_reader() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_changed.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    if (m_file) {
+        std::fclose(m_file);
+    }
+}
+
+bool decompressing_reader::is_open() const {
+    return m_file != nullptr;
+}
+
+long decompressing_reader::read(char *buffer, size_t size) {
+    if (m_current_pos == m_current.size()) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_current.capacity()) {
+            // přečtený blok vrátíme vláknu k dalšímu plnění
+            m_free.push_back(std::move(m_current));
+            m_current.clear();
+        }
+        m_changed.wait(lock, [this]() { return !m_full.empty() || m_finished; });
+        if (m_full.empty()) {
+            return m_failed ? -1 : 0;
+        }
+        m_current = std::move(m_full.front());
+        m_full.pop_front();
+        m_current_pos = 0;
+        lock.unlock();
+        m_changed.notify_all();
+    }
+    size_t n = std::min(size, m_current.size() - m_current_pos);
+    std::memcpy(buffer, m_current.data() + m_current_pos, n);
+    m_current_pos += n;
+    return static_cast<long>(n);
+}
+
+bool decompressing_reader::push_block(std::vector<char> &block) {
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_changed.wait(lock, [this]() { return m_full.size() < queue_depth || m_stop; });
+        if (m_stop) {
+            return false;
+        }
+        m_full.push_back(std::move(block));
+        block.clear();
+        if (!m_free.empty()) {
+            block = std::move(m_free.back());
+            m_free.pop_back();
+        }
+    }
+    m_changed.notify_all();
+    block.resize(output_block_size);
+    return true;
+}
+
+void decompressing_reader::run() {
+    bool ok = m_kind == compression::gzip ? inflate_gzip() : inflate_zstd();
+    {
+        std::lock_guard<std::mutex> lock(errors_mutex);
+        if (ok) {
+            errors.erase(m_file_name);
+        } else {
+            errors[m_file_name] = m_error;
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_finished = true;
+        m_failed = !ok;
+    }
+    m_changed.notify_all();
+}
+
+bool decompressing_reader::inflate_gzip() {
+#ifdef WC_HAVE_ZLIB
+    z_stream stream{};
+    // 15 + 32: maximální okno a automatické rozpoznání hlavičky gzip/zlib
+    if (inflateInit2(&stream, 15 + 32) != Z_OK) {
+        m_error = "zlib initialization failed";
+        return false;
+    }
+    std::vector<char> input(input_block_size);
+    std::vector<char> block(output_block_size);
+    size_t used = 0;
+    bool ok = true;
+    bool member_open = false;
+    size_t members = 0;
+    bool output_full = false;
+    while (true) {
+        // dokud je výstup plný, může mít inflate data ještě v sobě, číst nemusíme
+        if (stream.avail_in == 0 && !output_full) {
+            size_t n = std::fread(input.data(), 1, input.size(), m_file);
+            if (n == 0) {
+                if (std::ferror(m_file)) {
+                    m_error = "read error";
+                } else if (member_open) {
+                    m_error = "unexpected end of data (truncated file)";
+                }
+                ok = m_error.empty();
+                break;
+            }
+            stream.next_in = reinterpret_cast<Bytef *>(input.data());
+            stream.avail_in = static_cast<uInt>(n);
+        }
+        if (!member_open && stream.avail_in > 0) {
+            if (members > 0) {
+                // za posledním členem gzip ignoruje nulové doplnění i data
+                // bez hlavičky 1f 8b, soubor tím není poškozený
+                while (stream.avail_in > 0 && *stream.next_in == 0) {
+                    ++stream.next_in;
+                    --stream.avail_in;
+                }
+                if (stream.avail_in == 0) {
+                    output_full = false;
+                    continue;
+                }
+                if (stream.next_in[0] != 0x1f || (stream.avail_in > 1 && stream.next_in[1] != 0x8b)) {
+                    break;
+                }
+            }
+            // začátek dalšího zřetězeného členu
+            inflateReset(&stream);
+            member_open = true;
+        }
+        stream.next_out = reinterpret_cast<Bytef *>(block.data() + used);
+        stream.avail_out = static_cast<uInt>(block.size() - used);
+        int ret = inflate(&stream, Z_NO_FLUSH);
+        used = block.size() - stream.avail_out;
+        if (ret == Z_STREAM_END) {
+            member_open = false;
+            ++members;
+        } else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+            m_error = stream.msg ? stream.msg : zError(ret);
+            ok = false;
+            break;
+        }
+        output_full = used == block.size();
+        if (output_full) {
+            if (!push_block(block)) {
+                break;
+            }
+            used = 0;
+        }
+    }
+    inflateEnd(&stream);
+    // i u poškozených dat předáme, co se před chybou rozbalilo
+    if (used > 0) {
+        block.resize(used);
+        push_block(block);
+    }
+    return ok;
+#else
+    return false;
+#endif
+}
+
+bool decompressing_reader::inflate_zstd() {
+#ifdef WC_HAVE_ZSTD
+    ZSTD_DStream *stream = ZSTD_createDStream();
+    if (!stream || ZSTD_isError(ZSTD_initDStream(stream))) {
+        ZSTD_freeDStream(stream);
+        m_error = "zstd initialization failed";
+        return false;
+    }
+    std::vector<char> input(ZSTD_DStreamInSize());
+    std::vector<char> block(output_block_size);
+    ZSTD_inBuffer in{input.data(), 0, 0};
+    size_t used = 0;
+    size_t remaining = 0;
+    bool ok = true;
+    bool output_full = false;
+    while (true) {
+        // dokud je výstup plný, může mít dekodér data ještě v sobě, číst nemusíme
+        if (in.pos == in.size && !output_full) {
+            size_t n = std::fread(input.data(), 1, input.size(), m_file);
+            if (n == 0) {
+                // 0 znamená, že poslední rámec je celý
+                if (std::ferror(m_file)) {
+                    m_error = "read error";
+                } else if (remaining != 0) {
+                    m_error = "unexpected end of data (truncated file)";
+                }
+                ok = m_error.empty();
+                break;
+            }
+            in.size = n;
+            in.pos = 0;
+        }
+        ZSTD_outBuffer out{block.data(), block.size(), used};
+        remaining = ZSTD_decompressStream(stream, &out, &in);
+        if (ZSTD_isError(remaining)) {
+            m_error = ZSTD_getErrorName(remaining);
+            ok = false;
+            break;
+        }
+        used = out.pos;
+        output_full = used == block.size();
+        if (output_full) {
+            if (!push_block(block)) {
+                break;
+            }
+            used = 0;
+        }
+    }
+    ZSTD_freeDStream(stream);
+    // i u poškozených dat předáme, co se před chybou rozbalilo
+    if (used > 0) {
+        block.resize(used);
+        push_block(block);
+    }
+    return ok;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class compression {
+    none,
+    gzip, //!< .gz (i více zřetězených členů)
+    zstd, //!< .zst
+};
+
+//! Pozná kompresi podle přípony jména souboru.
+compression compression_of(const std::string &file_name);
+
+//! Vrací true, pokud byl program přeložen s podporou dané komprese.
+bool compression_supported(compression kind);
+
+/**
+ * Vrátí popis chyby (od zlib/zstd), se kterou naposledy selhalo rozbalování
+ * souboru `file_name`, nebo prázdný řetězec, pokud poslední rozbalení
+ * proběhlo celé (nebo soubor nebyl rozbalován). Volající tak po neúspěchu
+ * odliší poškozená data od souboru, který nešel otevřít.
+ */
+std::string decompression_error(const std::string &file_name);
+
+/**
+ * Čtení komprimovaného souboru, které se rozbalí na vlastním vlákně.
+ *
+ * Vlákno čte soubor, rozbaluje ho do bloků po 1 MB a předává je přes
+ * frontu omezené délky; read() z fronty jen kopíruje. Rozbalování tak běží
+ * souběžně s počítáním a do paměti se nikdy nevejde víc než několik bloků.
+ * U poškozených dat se předá i vše, co se před chybou rozbalit podařilo,
+ * a chyba se zaznamená pro decompression_error().
+ */
+class decompressing_reader {
+public:
+    decompressing_reader(const std::string &file_name, compression kind);
+
+    //! Zastaví rozbalování (i nedokončené) a počká na vlákno.
+    ~decompressing_reader();
+
+    decompressing_reader(const decompressing_reader &) = delete;
+
+    decompressing_reader &operator=(const decompressing_reader &) = delete;
+
+    //! Vrací true, pokud soubor šel otevřít a komprese je podporovaná.
+    bool is_open() const;
+
+    /**
+     * Zkopíruje do `buffer` nejvýše `size` rozbalených bajtů a vrátí jejich
+     * počet, 0 na konci dat a -1, pokud jsou data poškozená.
+     */
+    long read(char *buffer, size_t size);
+
+private:
+    //! Tělo vlákna: rozbaluje, dokud nedojdou data nebo nepřijde stop.
+    void run();
+
+    bool inflate_gzip();
+
+    bool inflate_zstd();
+
+    //! Odešle plný blok do fronty a vrátí prázdný k dalšímu plnění; false po stop.
+    bool push_block(std::vector<char> &block);
+
+    std::string m_file_name;
+    compression m_kind;
+    std::FILE *m_file = nullptr;
+    std::string m_error; //!< popis chyby rozbalování, píše jen vlákno
+
+    std::mutex m_mutex;
+    std::condition_variable m_changed;
+    std::deque<std::vector<char>> m_full;
+    std::vector<std::vector<char>> m_free;
+    bool m_finished = false;
+    bool m_failed = false;
+    bool m_stop = false;
+
+    std::vector<char> m_current;
+    size_t m_current_pos = 0;
+
+    std::thread m_thread;
+};
@@ -0,0 +1,136 @@
+#include "file_pool.hpp"
+#include "counter.hpp"
+#include "decompress.hpp"
+#include "work_pool.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace {
+    //! O kolik souborů na vlákno smí počítání předběhnout vypisování.
+    const size_t results_ahead_per_job = 4;
+
+    //! Soubory delší než dva úseky se počítají po úsecích na více vláknech.
+    const size_t split_chunk_size = 8 << 20;
+}
+
+void count_files_separately(const std::vector<std::string> &files, unsigned jobs,
+                            const tokenizer_options &options,
+                            const std::function<void(size_t, file_result &)> &on_result,
+                            bool collect_stats) {
+    jobs = std::max(1u, jobs);
+    if (jobs == 1 || files.size() <= 1) {
+        // jediný soubor rozdělíme na úseky mezi všechna vlákna
+        for (size_t i = 0; i < files.size(); ++i) {
+            file_result result;
+            result.opened = count_words_in_file(files[i], jobs, result.words, options,
+                                                collect_stats ? &result.stats : nullptr);
+            on_result(i, result);
+        }
+        return;
+    }
+
+    const size_t window = results_ahead_per_job * jobs;
+    std::vector<std::unique_ptr<file_result>> results(files.size());
+    std::mutex mutex;
+    std::condition_variable result_ready;
+    size_t next_file = 0;
+    size_t next_print = 0;
+
+    auto publish = [&](size_t index, std::unique_ptr<file_result> result) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            results[index] = std::move(result);
+        }
+        result_ready.notify_one();
+    };
+
+    work_stealing_pool pool(jobs, [&](size_t worker) {
+        size_t index;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (next_file >= files.size()) {
+                return work_stealing_pool::feed_result::exhausted;
+            }
+            if (next_file >= next_print + window) {
+                return work_stealing_pool::feed_result::empty;
+            }
+            index = next_file++;
+        }
+        auto result = std::make_unique<file_result>();
+        run_stats *stats = collect_stats ? &result->stats : nullptr;
+        std::shared_ptr<chunked_file> job;
+        if (compression_of(files[index]) == compression::none) {
+            job = split_file(files[index], split_chunk_size, stats);
+        }
+        if (!job || job->chunks.size() <= 1) {
+            if (job) {
+                result->opened = true;
+                for (const auto &chunk : job->chunks) {
+                    count_words_in_range(chunk.first, chunk.second, result->words, options, stats);
+                }
+            } else {
+                // komprimovaný soubor, nebo se soubor nepodařilo namapovat
+                result->opened = count_words_in_file(files[index], 1, result->words, options, stats);
+            }
+            publish(index, std::move(result));
+            return work_stealing_pool::feed_result::worked;
+        }
+
+        // velký soubor: úseky počítají všechna volná vlákna, každé do své tabulky
+        // pro tento soubor, a poslední dokončený úsek tabulky sloučí do výsledku
+        struct split_result {
+            std::unique_ptr<file_result> result;
+            std::vector<word_table> tables;
+            std::vector<run_stats> stats;
+        };
+        auto shared = std::make_shared<split_result>();
+        shared->result = std::move(result);
+        shared->result->opened = true;
+        shared->tables.resize(pool.size());
+        shared->stats.resize(pool.size());
+        for (size_t i = 0; i < job->chunks.size(); ++i) {
+            pool.push(worker, [&, job, shared, index, i](size_t w) {
+                count_words_in_range(job->chunks[i].first, job->chunks[i].second, shared->tables[w], options,
+                                     collect_stats ? &shared->stats[w] : nullptr);
+                if (--job->remaining > 0) {
+                    return;
+                }
+                file_result &done = *shared->result;
+                phase_timer merge_timer(collect_stats ? &done.stats : nullptr, phase::merge);
+                for (const auto &table : shared->tables) {
+                    done.words.merge(table);
+                }
+                merge_timer.stop();
+                if (collect_stats) {
+                    for (const auto &local : shared->stats) {
+                        done.stats.merge(local);
+                    }
+                }
+                publish(index, std::move(shared->result));
+            });
+        }
+        return work_stealing_pool::feed_result::worked;
+    });
+    pool.start();
+
+    while (next_print < files.size()) {
+        std::unique_ptr<file_result> result;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            result_ready.wait(lock, [&]() { return results[next_print] != nullptr; });
+            result = std::move(results[next_print]);
+        }
+        on_result(next_print, *result);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++next_print;
+        }
+        // uvolnilo se místo v okně, vlákna mohou vzít další soubor
+        pool.wake();
+    }
+    pool.wait();
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "stats.hpp"
+#include "tokenizer.hpp"
+#include "word_table.hpp"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+//! Výsledek počítání jednoho souboru.
+struct file_result {
+    bool opened = false;
+    word_table words;
+    run_stats stats; //!< vyplněné jen při `collect_stats`
+};
+
+/**
+ * Spočítá každý ze souborů `files` do vlastní tabulky na nejvýše `jobs`
+ * vláknech najednou.
+ *
+ * Vlákna si berou soubory s kradením práce (work_stealing_pool). Velký
+ * soubor se rozdělí na úseky po 8 MB, které si rozeberou nečinná vlákna
+ * do samostatných tabulek, a ty se po posledním úseku sloučí. Jeden obrovský
+ * soubor mezi malými tak nepočítá jediné vlákno.
+ *
+ * `on_result(index, result)` se volá na volajícím vlákně přesně v pořadí
+ * souborů ve `files`, jakmile je daný soubor (a všechny před ním) hotový.
+ * Aby se paměť nezaplnila výsledky, které ještě nejsou na řadě, pracovní
+ * vlákna předbíhají vypisování nejvýše o několik souborů.
+ *
+ * S `collect_stats` se do každého výsledku změří i statistiky počítání.
+ */
+void count_files_separately(const std::vector<std::string> &files, unsigned jobs,
+                            const tokenizer_options &options,
+                            const std::function<void(size_t, file_result &)> &on_result,
+                            bool collect_stats = false);
@@ -0,0 +1,100 @@
+#include "heavy_hitters.hpp"
+
+#include <algorithm>
+
+space_saving::space_saving(size_t capacity) : m_capacity(std::max<size_t>(capacity, 1)) {
+    m_items.reserve(m_capacity);
+    m_heap.reserve(m_capacity);
+    m_heap_pos.reserve(m_capacity);
+    m_index.reserve(m_capacity);
+}
+
+void space_saving::add(std::string_view word, long count) {
+    if (word.empty()) {
+        return;
+    }
+    m_total += count;
+    auto it = m_index.find(word);
+    if (it != m_index.end()) {
+        m_items[it->second].count += count;
+        sift_down(m_heap_pos[it->second]);
+        return;
+    }
+    if (m_items.size() < m_capacity) {
+        size_t index = m_items.size();
+        m_items.push_back({std::string(word), count, 0});
+        m_heap.push_back(index);
+        m_heap_pos.push_back(index);
+        m_index.emplace(m_items[index].word, index);
+        sift_up(index);
+        return;
+    }
+    size_t index = m_heap[0];
+    item &victim = m_items[index];
+    m_index.erase(victim.word);
+    victim.word.assign(word.data(), word.size());
+    victim.error = victim.count;
+    victim.count += count;
+    m_index.emplace(victim.word, index);
+    sift_down(0);
+}
+
+std::vector<space_saving::item> space_saving::top(size_t k) const {
+    std::vector<item> ret(m_items);
+    auto by_count = [](const item &lhs, const item &rhs) {
+        return lhs.count != rhs.count ? lhs.count > rhs.count : lhs.word < rhs.word;
+    };
+    k = std::min(k, ret.size());
+    std::partial_sort(ret.begin(), ret.begin() + static_cast<std::ptrdiff_t>(k), ret.end(), by_count);
+    ret.resize(k);
+    return ret;
+}
+
+long space_saving::total() const {
+    return m_total;
+}
+
+size_t space_saving::capacity() const {
+    return m_capacity;
+}
+
+void space_saving::clear() {
+    m_index.clear();
+    m_items.clear();
+    m_heap.clear();
+    m_heap_pos.clear();
+    m_total = 0;
+}
+
+void space_saving::sift_down(size_t pos) {
+    while (true) {
+        size_t smallest = pos;
+        for (size_t child = 2 * pos + 1; child <= 2 * pos + 2 && child < m_heap.size(); ++child) {
+            if (m_items[m_heap[child]].count < m_items[m_heap[smallest]].count) {
+                smallest = child;
+            }
+        }
+        if (smallest == pos) {
+            return;
+        }
+        swap_heap(pos, smallest);
+        pos = smallest;
+    }
+}
+
+void space_saving::sift_up(size_t pos) {
+    while (pos > 0) {
+        size_t parent = (pos - 1) / 2;
+        if (m_items[m_heap[parent]].count <= m_items[m_heap[pos]].count) {
+            return;
+        }
+        swap_heap(pos, parent);
+        pos = parent;
+    }
+}
+
+void space_saving::swap_heap(size_t a, size_t b) {
+    std::swap(m_heap[a], m_heap[b]);
+    m_heap_pos[m_heap[a]] = a;
+    m_heap_pos[m_heap[b]] = b;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Odhad nejčastějších slov algoritmem Space-Saving v konstantní paměti.
+ *
+ * Udržuje nejvýše `capacity` čítačů. Pokud přijde slovo, které nemá čítač
+ * a všechny jsou obsazené, převezme čítač s nejmenší hodnotou min a začne
+ * od min + 1. Každé slovo, které se ve vstupu vyskytlo více než
+ * N / capacity krát (N je počet všech slov), má zaručeně čítač, a jeho
+ * hodnota je nadhodnocená nejvýše o `error`.
+ */
+class space_saving {
+public:
+    struct item {
+        std::string word;
+        long count = 0; //!< horní odhad počtu výskytů
+        long error = 0; //!< o kolik může být count nadhodnocený
+    };
+
+    explicit space_saving(size_t capacity);
+
+    // Klíče m_index ukazují do řetězců v m_items. Po kopii by ukazovaly do
+    // původního objektu a po přesunu krátkých (SSO) řetězců do uvolněné
+    // paměti, proto se objekt nekopíruje ani nepřesouvá.
+    space_saving(const space_saving &) = delete;
+
+    space_saving &operator=(const space_saving &) = delete;
+
+    void add(std::string_view word, long count = 1);
+
+    //! Nejvýše `k` slov s nejvyšším count, sestupně (při shodě podle slova).
+    std::vector<item> top(size_t k) const;
+
+    //! Počet všech přidaných výskytů.
+    long total() const;
+
+    size_t capacity() const;
+
+    void clear();
+
+private:
+    void sift_down(size_t pos);
+
+    void sift_up(size_t pos);
+
+    void swap_heap(size_t a, size_t b);
+
+    //! čítače, jejich adresy se po konstrukci nemění (klíče mapy na ně ukazují)
+    std::vector<item> m_items;
+    //! min-halda indexů do m_items podle count
+    std::vector<size_t> m_heap;
+    //! pozice každého čítače v m_heap
+    std::vector<size_t> m_heap_pos;
+    std::unordered_map<std::string_view, size_t> m_index;
+    size_t m_capacity;
+    long m_total = 0;
+};
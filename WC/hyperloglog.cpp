@@ -0,0 +1,87 @@
+#include "hyperloglog.hpp"
+#include "classify.hpp"
+#include "word_table.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+hyperloglog::hyperloglog(unsigned precision)
+        : m_precision(std::clamp(precision, min_precision, max_precision)),
+          m_registers(size_t(1) << m_precision, 0) {
+}
+
+unsigned hyperloglog::precision_for_error(double error) {
+    unsigned precision = min_precision;
+    while (precision < max_precision && 1.04 / std::sqrt(static_cast<double>(size_t(1) << precision)) > error) {
+        ++precision;
+    }
+    return precision;
+}
+
+void hyperloglog::add(std::string_view word) {
+    if (!word.empty()) {
+        add_hash(hash_word(word));
+    }
+}
+
+void hyperloglog::add_hash(uint64_t hash) {
+    size_t index = static_cast<size_t>(hash >> (64 - m_precision));
+    // zarážka za zbytkem hashe, aby řada nul nebyla delší než 64 - precision
+    uint64_t rest = (hash << m_precision) | (uint64_t(1) << (m_precision - 1));
+    auto rank = static_cast<uint8_t>(64 - highest_bit(rest));
+    if (rank > m_registers[index]) {
+        m_registers[index] = rank;
+    }
+}
+
+void hyperloglog::merge(const hyperloglog &other) {
+    if (other.m_precision != m_precision) {
+        return;
+    }
+    for (size_t i = 0; i < m_registers.size(); ++i) {
+        m_registers[i] = std::max(m_registers[i], other.m_registers[i]);
+    }
+}
+
+double hyperloglog::estimate() const {
+    const auto m = static_cast<double>(m_registers.size());
+    double alpha;
+    switch (m_registers.size()) {
+        case 16:
+            alpha = 0.673;
+            break;
+        case 32:
+            alpha = 0.697;
+            break;
+        case 64:
+            alpha = 0.709;
+            break;
+        default:
+            alpha = 0.7213 / (1 + 1.079 / m);
+    }
+    double sum = 0;
+    size_t zeros = 0;
+    for (uint8_t r : m_registers) {
+        sum += std::ldexp(1.0, -static_cast<int>(r));
+        zeros += r == 0;
+    }
+    double raw = alpha * m * m / sum;
+    if (raw <= 2.5 * m && zeros > 0) {
+        // malé počty: lineární počítání podle prázdných registrů
+        return m * std::log(m / static_cast<double>(zeros));
+    }
+    // 64bitový hash nepotřebuje korekci pro velké počty
+    return raw;
+}
+
+double hyperloglog::standard_error() const {
+    return 1.04 / std::sqrt(static_cast<double>(m_registers.size()));
+}
+
+size_t hyperloglog::memory() const {
+    return m_registers.size();
+}
+
+unsigned hyperloglog::precision() const {
+    return m_precision;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/**
+ * Odhad počtu různých slov algoritmem HyperLogLog v konstantní paměti.
+ *
+ * Hash slova vybere horními `precision` bity jeden z m = 2^precision
+ * registrů a registr si pamatuje nejdelší pozorovanou řadu nul na začátku
+ * zbytku hashe. Paměť je m bajtů, relativní chyba odhadu je přibližně
+ * 1.04 / sqrt(m). Pro malé počty se odhad opravuje lineárním počítáním
+ * prázdných registrů.
+ */
+class hyperloglog {
+public:
+    static constexpr unsigned min_precision = 4;
+    static constexpr unsigned max_precision = 18;
+
+    explicit hyperloglog(unsigned precision = 14);
+
+    //! Nejmenší přesnost, při které je relativní chyba nejvýše `error`.
+    static unsigned precision_for_error(double error);
+
+    void add(std::string_view word);
+
+    //! Přidá slovo s již spočítaným hash_word().
+    void add_hash(uint64_t hash);
+
+    //! Přičte všechna slova z jiného odhadu se stejnou přesností.
+    void merge(const hyperloglog &other);
+
+    //! Odhad počtu různých přidaných slov.
+    double estimate() const;
+
+    //! Očekávaná relativní chyba odhadu.
+    double standard_error() const;
+
+    //! Paměť registrů v bajtech.
+    size_t memory() const;
+
+    unsigned precision() const;
+
+private:
+    unsigned m_precision;
+    std::vector<uint8_t> m_registers;
+};
@@ -0,0 +1,65 @@
+#include "inputs.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <system_error>
+
+#if !defined(_WIN32)
+#include <glob.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+    bool is_pattern(const std::string &input) {
+        return input.find_first_of("*?[") != std::string::npos;
+    }
+
+    //! Přidá do `out` soubor, nebo všechny soubory pod adresářem `path`.
+    void add_path(const std::string &path, std::vector<std::string> &out) {
+        std::error_code error;
+        if (!fs::is_directory(path, error)) {
+            out.push_back(path);
+            return;
+        }
+        std::vector<std::string> found;
+        fs::recursive_directory_iterator it(path, fs::directory_options::skip_permission_denied, error);
+        for (; !error && it != fs::recursive_directory_iterator(); it.increment(error)) {
+            if (it->is_regular_file(error)) {
+                found.push_back(it->path().string());
+            }
+        }
+        std::sort(found.begin(), found.end());
+        out.insert(out.end(), found.begin(), found.end());
+    }
+
+    //! Rozbalí vzor; vrací false, pokud nic nenašel.
+    bool add_matches(const std::string &pattern, std::vector<std::string> &out) {
+#if !defined(_WIN32)
+        glob_t matches{};
+        bool found = ::glob(pattern.c_str(), 0, nullptr, &matches) == 0;
+        for (size_t i = 0; found && i < matches.gl_pathc; ++i) {
+            add_path(matches.gl_pathv[i], out);
+        }
+        ::globfree(&matches);
+        return found;
+#else
+        (void) pattern;
+        (void) out;
+        return false;
+#endif
+    }
+}
+
+std::vector<std::string> expand_inputs(const std::vector<std::string> &inputs) {
+    std::vector<std::string> files;
+    for (const auto &input : inputs) {
+        std::error_code error;
+        if (input == "-") {
+            files.push_back(input);
+        } else if (fs::exists(input, error) || !is_pattern(input) || !add_matches(input, files)) {
+            add_path(input, files);
+        }
+    }
+    return files;
+}
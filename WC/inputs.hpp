@@ -0,0 +1,19 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * Rozbalí vstupy z příkazové řádky na seznam souborů.
+ *
+ * - Adresář se nahradí všemi běžnými soubory v něm i v podadresářích,
+ *   seřazenými podle cesty (symbolické odkazy na adresáře se neprochází).
+ * - Vstup se znaky `*`, `?` nebo `[`, který neexistuje jako soubor, se
+ *   bere jako glob (na POSIX přes glob(3)); nalezené adresáře se dál
+ *   rozbalí jako výše. Vzor, který nic nenajde, zůstane beze změny,
+ *   aby ho volající ohlásil jako nenalezený soubor.
+ * - Ostatní vstupy (včetně `-`) zůstanou, jak jsou.
+ *
+ * Pořadí vstupů se zachovává.
+ */
+std::vector<std::string> expand_inputs(const std::vector<std::string> &inputs);
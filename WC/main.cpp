@@ -1,94 +1,177 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
-#include <fstream>
-#include <map>
-#include <ctype.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <thread>
+#include "count_index.hpp"
+#include "counter.hpp"
+#include "decompress.hpp"
+#include "file_pool.hpp"
+#include "inputs.hpp"
+#include "ngram.hpp"
+#include "output.hpp"
+#include "spill.hpp"
+#include "stream.hpp"
 
-std::map<std::string, long> words_map;
+word_table words_map;
+unsigned jobs = 0;
+tokenizer_options token_options;
+run_stats stats;
+bool collect_stats = false;
 
 void help() {
-    std::cout << "usage: WC [OPTION]...  [FILE]..." << std::endl
+    std::cout << "usage: WC [OPTION]...  [FILE|DIRECTORY|PATTERN]..." << std::endl
               << "options: " << std::endl <<
               "-h, --help            to print help manual" << std::endl <<
-              "-s, --separate-files  count words for each file separated" << std::endl;
+              "-s, --separate-files  count words for each file separated (files are counted in parallel)" << std::endl <<
+              "-j, --jobs N          number of threads counting one file (default: all cores)" << std::endl <<
+              "-f, --format FORMAT   output format: text (default), tsv or binary" << std::endl <<
+              "-i, --ignore-case     count words case-insensitively (UTF-8 aware)" << std::endl <<
+              "--io-backend B        how small files are read ahead: auto (io_uring where available)" << std::endl <<
+              "                      or threads" << std::endl <<
+              "--stats               print bytes, words, hash table and per-phase timing statistics" << std::endl <<
+              "                      to stderr (word counting without -, index or other modes)" << std::endl <<
+              "-                     read standard input; enables streaming mode" << std::endl <<
+              "--write-index FILE    write the counts into a new index FILE instead of printing them" << std::endl <<
+              "--update-index FILE   add the counts to the index FILE (created if missing or empty)" << std::endl <<
+              "--print-index FILE    print the contents of the index FILE" << std::endl <<
+              "--ngram N             count sequences of N consecutive words instead of words" << std::endl <<
+              "--cooccur W           count pairs of words occurring within a window of W words" << std::endl <<
+              "                      (both can be used together; all files are counted together)" << std::endl <<
+              "--memory-limit MB     count all files together within MB of memory, spilling to disk" << std::endl <<
+              "                      (reads files sequentially on one thread)" << std::endl <<
+              "--temp-dir DIR        directory for the spill files (default: system temp directory)" << std::endl <<
+              "streaming mode (bounded memory, approximate top words):" << std::endl <<
+              "--approx              use streaming mode for files too and estimate the number of distinct words" << std::endl <<
+              "--error E             relative error of the distinct estimate (default: 0.01)" << std::endl <<
+              "-k, --top K           number of most frequent words to print (default: 10)" << std::endl <<
+              "--capacity N          number of word counters kept in memory (default: 10000)" << std::endl <<
+              "--snapshot-mb N       print current top words after every N MB of input" << std::endl <<
+              "--snapshot-sec N      print current top words every N seconds" << std::endl;
 //              "-t, --total           total count of words" << std::endl;
 }
 
-void push_word_to_map(const std::string &word) {
-    if (!word.empty()) {
-        try {
-            words_map.at(word)++;
-        } catch (std::out_of_range e) {
-            words_map[word] = 1;
-        }
+void print_map(const word_table &words, output_writer &out) {
+    phase_timer timer(collect_stats ? &stats : nullptr, phase::print);
+    for (const auto &pair:words.sorted()) {
+        out.entry(pair.first, pair.second);
     }
 }
 
-void print_map() {
-    for (const auto &pair:words_map) {
-        std::cout << pair.first << " | " << pair.second << std::endl;
+void print_file_error(const std::string &file_name, output_writer &out) {
+    if (!compression_supported(compression_of(file_name))) {
+        out.message("File " + file_name + " is compressed in a format this build does not support!");
+        return;
+    }
+    std::string error = decompression_error(file_name);
+    if (!error.empty()) {
+        out.message("File " + file_name + " decompression failed: " + error + "!");
+        return;
     }
+    out.message("File " + file_name + " NOT found or could not be opened!");
 }
 
+void count_word_for_file(const std::string &file_name, output_writer &out) {
+    if (!count_words_in_file(file_name, jobs, words_map, token_options, collect_stats ? &stats : nullptr)) {
+        print_file_error(file_name, out);
+    }
+}
+
+bool find_arg(std::vector<std::string> &args, const std::string &str) {
+    return std::find(args.begin(), args.end(), str) != args.end();
+}
+
+bool take_arg_value(std::vector<std::string> &args, const std::string &str, std::string &value) {
+    auto it = std::find(args.begin(), args.end(), str);
+    if (it == args.end() || it + 1 == args.end()) {
+        return false;
+    }
+    value = *(it + 1);
+    args.erase(it, it + 2);
+    return true;
+}
+
+bool take_arg_number(std::vector<std::string> &args, const std::string &short_name, const std::string &long_name,
+                     size_t &value) {
+    std::string str;
+    if (take_arg_value(args, long_name, str) || (!short_name.empty() && take_arg_value(args, short_name, str))) {
+        value = std::strtoul(str.c_str(), nullptr, 10);
+        return true;
+    }
+    return false;
+}
 
-std::string remove_special_chars(std::string *word) {
-    if (word->length() == 0) {
-        return *word;
+int print_index(const std::string &file_name, output_writer &out) {
+    count_index index(file_name);
+    if (!index.is_valid()) {
+        out.message("File " + file_name + " is not a valid index!");
+        return 1;
     }
-    const char first_char = (*word)[0];
-    const char last_char = (*word)[word->length() - 1];
-    if (isalnum(first_char) && isalnum(last_char)) {
-        return *word;
+    for (size_t i = 0; i < index.size(); ++i) {
+        out.entry(index.word(i), index.count(i));
     }
-    if (!isalnum(first_char)) {
-        word->erase(0, 1);
+    return 0;
+}
+
+int count_spilling(const std::vector<std::string> &arguments, size_t memory_limit, const std::string &temp_dir,
+                   output_writer &out) {
+    spilling_counter counter(memory_limit, temp_dir);
+    for (const auto &arg: arguments) {
+        if (!count_file_spilling(arg, counter, token_options)) {
+            print_file_error(arg, out);
+        }
     }
-    if (!isalnum(last_char)) {
-        word->pop_back();
+    if (!counter.finish([&out](std::string_view word, long count) { out.entry(word, count); })) {
+        out.message("Spill files could not be written or read!");
+        return 1;
     }
-    return remove_special_chars(word);
+    return 0;
 }
 
-void count_word_for_file(const std::string &file_name) {
-    std::ifstream infile(file_name);
-    if (infile.is_open()) {
-//        long count = 0;
-        std::string line;
-        std::string word;
-        while (std::getline(infile, line)) {
-            char *str = const_cast<char *>(line.c_str());
-            int state = 0;
-            while (*str) {
-                if (*str == ' ' || *str == '\n' || *str == '\t') {
-                    state = 0;
-                } else if (state == 0) {
-                    state = 1;
-                    push_word_to_map(remove_special_chars(&word));
-                    word.clear();
-//                    ++count;
-                }
-                if (state != 0) {
-                    word.push_back(*str);
-                }
-                ++str;
-            }
-            push_word_to_map(remove_special_chars(&word));
-            word.clear();
+int count_ngrams(const std::vector<std::string> &arguments, const ngram_options &ngram, output_writer &out) {
+    ngram_tables tables;
+    for (const auto &arg: arguments) {
+        if (!count_ngrams_in_file(arg, jobs, tables, ngram, token_options)) {
+            print_file_error(arg, out);
         }
-//        std::cout << count << std::endl;
-//total number of words
+    }
+    if (ngram.n > 0 && ngram.window > 1) {
+        out.begin_section(std::to_string(ngram.n) + "-grams", "Counts of ");
+        print_map(tables.ngrams, out);
+        out.end_section();
+        out.begin_section("co-occurrences in window " + std::to_string(ngram.window), "Counts of ");
+        print_map(tables.pairs, out);
+        out.end_section();
     } else {
-        std::cout << "File " << file_name << " NOT found or could not be opened!" << std::endl;
+        print_map(ngram.n > 0 ? tables.ngrams : tables.pairs, out);
     }
-    infile.close();
+    return 0;
 }
 
-bool find_arg(std::vector<std::string> &args, const std::string &str) {
-    return std::find(args.begin(), args.end(), str) != args.end();
+void count_streaming(const std::vector<std::string> &arguments, const stream_options &options, output_writer &out,
+                     hyperloglog *distinct) {
+    space_saving counters(options.capacity);
+    for (const auto &arg: arguments) {
+        if (!count_stream(arg, counters, options, out, distinct)) {
+            print_file_error(arg, out);
+        }
+    }
+    if (distinct) {
+        char line[128];
+        std::snprintf(line, sizeof(line), "Distinct words: ~%lld (relative error ~%.2f %%)",
+                      std::llround(distinct->estimate()), distinct->standard_error() * 100);
+        out.message(line);
+        out.message("Top counts overestimate by at most " +
+                    std::to_string(counters.total() / static_cast<long>(counters.capacity())));
+    }
+    print_top(counters, options.top_k, out);
 }
 
 int main(int argc, char *argv[]) {
+    const auto start_time = std::chrono::steady_clock::now();
     bool separate = false;
     if (argc < 2) {
         help();
@@ -106,19 +189,140 @@ int main(int argc, char *argv[]) {
             arguments.erase(std::find(arguments.begin(), arguments.end(), "-s"));
             separate = true;
         }
-        if (!separate) {
+        if (find_arg(arguments, "--ignore-case") || find_arg(arguments, "-i")) {
+            arguments.erase(std::remove(arguments.begin(), arguments.end(), "--ignore-case"), arguments.end());
+            arguments.erase(std::remove(arguments.begin(), arguments.end(), "-i"), arguments.end());
+            token_options.fold_case = true;
+        }
+        if (find_arg(arguments, "--stats")) {
+            arguments.erase(std::remove(arguments.begin(), arguments.end(), "--stats"), arguments.end());
+            collect_stats = true;
+        }
+        size_t jobs_value = 0;
+        if (take_arg_number(arguments, "-j", "--jobs", jobs_value)) {
+            jobs = static_cast<unsigned>(jobs_value);
+        }
+        if (jobs == 0) {
+            jobs = std::max(1u, std::thread::hardware_concurrency());
+        }
+        stream_options options;
+        options.tokens = token_options;
+        take_arg_number(arguments, "-k", "--top", options.top_k);
+        take_arg_number(arguments, "", "--capacity", options.capacity);
+        size_t snapshot_mb = 0;
+        size_t snapshot_sec = 0;
+        take_arg_number(arguments, "", "--snapshot-mb", snapshot_mb);
+        take_arg_number(arguments, "", "--snapshot-sec", snapshot_sec);
+        options.snapshot_bytes = snapshot_mb << 20;
+        options.snapshot_seconds = static_cast<unsigned>(snapshot_sec);
+        bool approx = false;
+        if (find_arg(arguments, "--approx")) {
+            arguments.erase(std::remove(arguments.begin(), arguments.end(), "--approx"), arguments.end());
+            approx = true;
+        }
+        double distinct_error = 0.01;
+        std::string error_value;
+        if (take_arg_value(arguments, "--error", error_value)) {
+            distinct_error = std::strtod(error_value.c_str(), nullptr);
+        }
+        hyperloglog distinct(hyperloglog::precision_for_error(distinct_error));
+        ngram_options ngram;
+        take_arg_number(arguments, "", "--ngram", ngram.n);
+        take_arg_number(arguments, "", "--cooccur", ngram.window);
+        size_t memory_limit_mb = 0;
+        std::string temp_dir;
+        take_arg_number(arguments, "", "--memory-limit", memory_limit_mb);
+        take_arg_value(arguments, "--temp-dir", temp_dir);
+        read_backend io_backend = read_backend::automatic;
+        std::string backend_name;
+        if (take_arg_value(arguments, "--io-backend", backend_name) && !parse_read_backend(backend_name, io_backend)) {
+            std::cerr << "Unknown I/O backend " << backend_name << std::endl;
+            return 1;
+        }
+        output_format format = output_format::text;
+        std::string format_name;
+        if ((take_arg_value(arguments, "--format", format_name) || take_arg_value(arguments, "-f", format_name)) &&
+            !parse_output_format(format_name, format)) {
+            std::cerr << "Unknown output format " << format_name << std::endl;
+            return 1;
+        }
+        output_writer out(stdout, format);
+        std::string print_index_name;
+        std::string write_index_name;
+        std::string update_index_name;
+        const bool print_index_mode = take_arg_value(arguments, "--print-index", print_index_name);
+        const bool write_index_mode = take_arg_value(arguments, "--write-index", write_index_name);
+        const bool update_index_mode = take_arg_value(arguments, "--update-index", update_index_name);
+        // zbylé argumenty jsou vstupy, adresáře a vzory rozbalíme na soubory
+        arguments = expand_inputs(arguments);
+        if (ngram.enabled()) {
+            if (separate || memory_limit_mb || print_index_mode || write_index_mode || update_index_mode) {
+                std::cerr << "--ngram and --cooccur cannot be combined with -s, --memory-limit or index options"
+                          << std::endl;
+                return 1;
+            }
+            return count_ngrams(arguments, ngram, out);
+        }
+        if (print_index_mode) {
+            return print_index(print_index_name, out);
+        }
+        if (write_index_mode) {
             for (const auto &arg: arguments) {
-                count_word_for_file(arg);
+                count_word_for_file(arg, out);
             }
-            print_map();
-        } else {
+            if (!write_index(write_index_name, words_map.sorted())) {
+                out.message("Index " + write_index_name + " could not be written!");
+                return 1;
+            }
+        } else if (update_index_mode) {
             for (const auto &arg: arguments) {
-                count_word_for_file(arg);
-                std::cout << "Words for file " << arg << std::endl;
-                print_map();
-                std::cout << std::endl;
-                words_map.clear();
+                count_word_for_file(arg, out);
+            }
+            if (!merge_into_index(update_index_name, words_map)) {
+                out.message("Index " + update_index_name + " could not be updated!");
+                return 1;
             }
+        } else if (approx || find_arg(arguments, stdin_name)) {
+            count_streaming(arguments, options, out, approx ? &distinct : nullptr);
+        } else if (!separate && memory_limit_mb) {
+            return count_spilling(arguments, memory_limit_mb << 20, temp_dir, out);
+        } else if (!separate && arguments.size() > 1) {
+            for (size_t index: count_words_in_files(arguments, jobs, words_map, token_options, io_backend,
+                                                    collect_stats ? &stats : nullptr)) {
+                print_file_error(arguments[index], out);
+            }
+            print_map(words_map, out);
+            if (collect_stats) {
+                stats.add_table(words_map);
+            }
+        } else if (!separate) {
+            for (const auto &arg: arguments) {
+                count_word_for_file(arg, out);
+            }
+            print_map(words_map, out);
+            if (collect_stats) {
+                stats.add_table(words_map);
+            }
+        } else {
+            count_files_separately(arguments, jobs, token_options, [&arguments, &out](size_t index, file_result &result) {
+                if (!result.opened) {
+                    print_file_error(arguments[index], out);
+                }
+                out.begin_section(arguments[index]);
+                print_map(result.words, out);
+                out.end_section();
+                if (collect_stats) {
+                    stats.merge(result.stats);
+                    stats.add_table(result.words);
+                }
+            }, collect_stats);
+        }
+        if (collect_stats) {
+            phase_timer timer(&stats, phase::print);
+            out.flush();
+            timer.stop();
+            print_stats(stderr, stats,
+                        std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count());
         }
 
     }
@@ -0,0 +1,83 @@
+#include "mapped_file.hpp"
+
+#include <fstream>
+#include <iterator>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+mapped_file::mapped_file(const std::string &file_name) {
+#if !defined(_WIN32)
+    int fd = ::open(file_name.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+        m_open = true;
+        m_size = static_cast<size_t>(st.st_size);
+        if (m_size == 0) {
+            ::close(fd);
+            return;
+        }
+        void *addr = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            ::madvise(addr, m_size, MADV_SEQUENTIAL);
+            m_data = static_cast<const char *>(addr);
+            m_mapped = true;
+            ::close(fd);
+            return;
+        }
+        m_open = false;
+        m_size = 0;
+    }
+    ::close(fd);
+#endif
+    m_open = read_to_buffer(file_name);
+}
+
+mapped_file::~mapped_file() {
+#if !defined(_WIN32)
+    if (m_mapped) {
+        ::munmap(const_cast<char *>(m_data), m_size);
+    }
+#endif
+}
+
+bool mapped_file::read_to_buffer(const std::string &file_name) {
+    std::ifstream infile(file_name, std::ios::binary);
+    if (!infile.is_open()) {
+        return false;
+    }
+    m_buffer.assign(std::istreambuf_iterator<char>(infile), std::istreambuf_iterator<char>());
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+    return true;
+}
+
+bool mapped_file::is_open() const {
+    return m_open;
+}
+
+const char *mapped_file::data() const {
+    return m_data;
+}
+
+size_t mapped_file::size() const {
+    return m_size;
+}
+
+void mapped_file::prefault() const {
+    if (!m_mapped) {
+        return;
+    }
+    const size_t page_size = 4096;
+    volatile char sink = 0;
+    for (size_t i = 0; i < m_size; i += page_size) {
+        sink = static_cast<char>(sink + m_data[i]);
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+/**
+ * Soubor zpřístupněný jako souvislý blok paměti.
+ *
+ * Na POSIX systémech se běžný soubor namapuje pomocí mmap, takže se nic
+ * nekopíruje. Pokud mapování není možné (roura, speciální soubor, Windows),
+ * načte se celý obsah do interního bufferu.
+ */
+class mapped_file {
+public:
+    explicit mapped_file(const std::string &file_name);
+
+    ~mapped_file();
+
+    mapped_file(const mapped_file &) = delete;
+
+    mapped_file &operator=(const mapped_file &) = delete;
+
+    //! Vrací true, pokud se soubor podařilo otevřít.
+    bool is_open() const;
+
+    const char *data() const;
+
+    size_t size() const;
+
+    /**
+     * Přečte každou stránku namapovaného souboru, aby se načetla z disku
+     * hned (pro měření doby čtení zvlášť od zpracování).
+     */
+    void prefault() const;
+
+private:
+    bool read_to_buffer(const std::string &file_name);
+
+    const char *m_data = nullptr;
+    size_t m_size = 0;
+    bool m_open = false;
+    bool m_mapped = false;
+    std::vector<char> m_buffer;
+};
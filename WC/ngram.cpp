@@ -0,0 +1,149 @@
+#include "ngram.hpp"
+#include "counter.hpp"
+#include "decompress.hpp"
+#include "mapped_file.hpp"
+#include "stream.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace {
+    //! Základ polynomu, kterým se skládají hashe slov.
+    const uint64_t hash_base = 0x100000001B3ull;
+
+    //! Promíchá složený hash, aby se dobře rozprostřel i v dolních bitech (index slotu).
+    uint64_t finish_hash(uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDull;
+        h ^= h >> 33;
+        return h;
+    }
+
+    /**
+     * Vlákno jednoho úseku: čte slova od `begin` až do konce souboru, ale
+     * za koncem úseku jen tolik slov, kolik je potřeba na kombinace, které
+     * začínají v úseku.
+     */
+    void count_chunk(const char *begin, const char *chunk_end, const char *file_end, ngram_tables &tables,
+                     const ngram_options &ngram, const tokenizer_options &options) {
+        ngram_window window(ngram);
+        tokenizer tokens(begin, file_end, options);
+        const auto chunk_size = static_cast<size_t>(chunk_end - begin);
+        size_t tail = 0;
+        std::string_view word;
+        while (tokens.next(word)) {
+            if (tokens.position() > chunk_size && ++tail > window.lookahead()) {
+                break;
+            }
+            window.push(word, tail, tables);
+        }
+    }
+}
+
+void ngram_tables::merge(const ngram_tables &other) {
+    ngrams.merge(other.ngrams);
+    pairs.merge(other.pairs);
+}
+
+ngram_window::ngram_window(const ngram_options &options)
+        : m_options(options), m_ring(std::max<size_t>({options.n, options.window, 1})) {
+    for (size_t i = 1; i < m_options.n; ++i) {
+        m_drop_factor *= hash_base;
+    }
+}
+
+const ngram_window::entry &ngram_window::back(size_t distance) const {
+    return m_ring[(m_next + m_ring.size() - 1 - distance) % m_ring.size()];
+}
+
+size_t ngram_window::lookahead() const {
+    return m_ring.size() - 1;
+}
+
+void ngram_window::push(std::string_view word, size_t skip_recent, ngram_tables &tables) {
+    const uint64_t hash = hash_word(word);
+    if (m_options.n > 0) {
+        // nejstarší slovo n-gramu z polynomu odečteme dřív, než ho v kruhu přepíšeme
+        if (m_seen >= m_options.n) {
+            m_rolling -= back(m_options.n - 1).hash * m_drop_factor;
+        }
+        m_rolling = m_rolling * hash_base + hash;
+    }
+    entry &slot = m_ring[m_next];
+    slot.word.assign(word.data(), word.size());
+    slot.hash = hash;
+    m_next = (m_next + 1) % m_ring.size();
+    ++m_seen;
+
+    if (m_options.n > 0 && m_seen >= m_options.n && m_options.n - 1 >= skip_recent) {
+        m_key.clear();
+        for (size_t distance = m_options.n - 1; distance > 0; --distance) {
+            m_key += back(distance).word;
+            m_key += ' ';
+        }
+        m_key += back(0).word;
+        tables.ngrams.add(m_key, finish_hash(m_rolling), 1);
+    }
+
+    const entry &last = back(0);
+    for (size_t distance = std::max<size_t>(skip_recent, 1);
+         distance < m_options.window && distance < m_seen; ++distance) {
+        const entry &other = back(distance);
+        const bool other_first = other.word <= last.word;
+        const entry &first = other_first ? other : last;
+        const entry &second = other_first ? last : other;
+        m_key.assign(first.word);
+        m_key += ' ';
+        m_key += second.word;
+        tables.pairs.add(m_key, finish_hash(first.hash * hash_base + second.hash), 1);
+    }
+}
+
+void count_ngrams_in_range(const char *begin, const char *end, ngram_window &window,
+                           ngram_tables &tables, const tokenizer_options &options) {
+    tokenizer tokens(begin, end, options);
+    std::string_view word;
+    while (tokens.next(word)) {
+        window.push(word, 0, tables);
+    }
+}
+
+bool count_ngrams_in_file(const std::string &file_name, unsigned jobs, ngram_tables &tables,
+                          const ngram_options &ngram, const tokenizer_options &options) {
+    if (file_name == stdin_name || compression_of(file_name) != compression::none) {
+        ngram_window window(ngram);
+        return read_in_blocks(file_name, [&](const char *begin, const char *end, size_t) {
+            count_ngrams_in_range(begin, end, window, tables, options);
+        });
+    }
+
+    mapped_file file(file_name);
+    if (!file.is_open()) {
+        return false;
+    }
+    const char *file_end = file.data() + file.size();
+    auto chunks = split_chunks(file.data(), file_end, jobs == 0 ? 1 : jobs);
+    if (chunks.size() <= 1) {
+        for (const auto &chunk : chunks) {
+            count_chunk(chunk.first, chunk.second, file_end, tables, ngram, options);
+        }
+        return true;
+    }
+
+    std::vector<ngram_tables> local_tables(chunks.size());
+    std::vector<std::thread> workers;
+    workers.reserve(chunks.size() - 1);
+    for (size_t i = 1; i < chunks.size(); ++i) {
+        workers.emplace_back(count_chunk, chunks[i].first, chunks[i].second, file_end, std::ref(local_tables[i]),
+                             std::cref(ngram), std::cref(options));
+    }
+    count_chunk(chunks[0].first, chunks[0].second, file_end, local_tables[0], ngram, options);
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    for (const auto &local : local_tables) {
+        tables.merge(local);
+    }
+    return true;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "tokenizer.hpp"
+#include "word_table.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct ngram_options {
+    size_t n = 0;      //!< délka počítaných n-gramů (0 = n-gramy nepočítat)
+    size_t window = 0; //!< šířka okna společných výskytů (0 = nepočítat)
+
+    bool enabled() const {
+        return n > 0 || window > 1;
+    }
+};
+
+//! Výsledky jednoho průchodu: n-gramy ("a b c") a dvojice slov z okna ("a b", a <= b).
+struct ngram_tables {
+    word_table ngrams;
+    word_table pairs;
+
+    void merge(const ngram_tables &other);
+};
+
+/**
+ * Posuvné okno posledních slov, ze kterého se skládají n-gramy a dvojice
+ * společných výskytů.
+ *
+ * Hash n-gramu se nepočítá z poskládaného klíče, ale průběžně z hashů slov
+ * (polynom v hashích posledních n slov: nové slovo se přičte, nejstarší
+ * odečte), takže každé slovo se hashuje jen jednou. Dvojice má hash složený
+ * z hashů obou slov. Klíč se skládá jen kvůli uložení a porovnání v tabulce.
+ *
+ * Okno si slova kopíruje, takže může pokračovat přes hranice bloků, jejichž
+ * paměť se mezi voláními přepíše.
+ */
+class ngram_window {
+public:
+    explicit ngram_window(const ngram_options &options);
+
+    /**
+     * Přidá další slovo a do `tables` přičte n-gram a dvojice, které jím
+     * končí. Započítají se jen ty, jejichž první slovo je starší než
+     * `skip_recent` posledních slov (včetně právě přidaného); úsek souboru
+     * tak může dočíst slova za svým koncem a započítat jen kombinace, které
+     * v něm začínají.
+     */
+    void push(std::string_view word, size_t skip_recent, ngram_tables &tables);
+
+    //! Kolik slov za koncem úseku je potřeba dočíst, aby se započítalo vše, co v něm začíná.
+    size_t lookahead() const;
+
+private:
+    struct entry {
+        std::string word;
+        uint64_t hash = 0;
+    };
+
+    //! Slovo `distance` pozic zpět (0 = poslední přidané).
+    const entry &back(size_t distance) const;
+
+    ngram_options m_options;
+    std::vector<entry> m_ring;
+    size_t m_next = 0;
+    size_t m_seen = 0;
+    uint64_t m_rolling = 0;
+    uint64_t m_drop_factor = 1;
+    std::string m_key;
+};
+
+//! Spočítá n-gramy a dvojice v úseku [begin, end) jednoho souboru do `tables`.
+void count_ngrams_in_range(const char *begin, const char *end, ngram_window &window,
+                           ngram_tables &tables, const tokenizer_options &options = tokenizer_options());
+
+/**
+ * Spočítá n-gramy a dvojice v souboru `file_name` (nebo ve standardním vstupu
+ * pro "-") a přičte je do `tables`. Standardní vstup a komprimované soubory
+ * se čtou po blocích jedním vláknem.
+ *
+ * Soubor se stejně jako při počítání slov rozdělí na nejvýše `jobs` úseků.
+ * Vlákno každého úseku dočte ještě několik slov za jeho koncem, aby se
+ * započítaly i kombinace přes hranici, a započítá jen ty, které v jeho
+ * úseku začínají, takže výsledek nezávisí na počtu vláken.
+ *
+ * Vrací false, pokud soubor nešel otevřít.
+ */
+bool count_ngrams_in_file(const std::string &file_name, unsigned jobs, ngram_tables &tables,
+                          const ngram_options &ngram, const tokenizer_options &options = tokenizer_options());
@@ -0,0 +1,160 @@
+#include "output.hpp"
+
+#include <cstring>
+#include <iostream>
+
+namespace {
+    const char digit_pairs[] =
+            "00010203040506070809"
+            "10111213141516171819"
+            "20212223242526272829"
+            "30313233343536373839"
+            "40414243444546474849"
+            "50515253545556575859"
+            "60616263646566676869"
+            "70717273747576777879"
+            "80818283848586878889"
+            "90919293949596979899";
+
+    const char binary_magic[] = "WCB1";
+}
+
+bool parse_output_format(const std::string &name, output_format &format) {
+    if (name == "text") {
+        format = output_format::text;
+    } else if (name == "tsv") {
+        format = output_format::tsv;
+    } else if (name == "binary") {
+        format = output_format::binary;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+output_writer::output_writer(std::FILE *file, output_format format, size_t buffer_size)
+        : m_file(file), m_format(format), m_buffer(buffer_size < 64 ? 64 : buffer_size) {
+    if (m_format == output_format::binary) {
+        append(binary_magic, sizeof(binary_magic) - 1);
+    }
+}
+
+output_writer::~output_writer() {
+    flush();
+}
+
+void output_writer::entry(std::string_view word, long count) {
+    switch (m_format) {
+        case output_format::text:
+            append(word);
+            append(" | ", 3);
+            append_number(count);
+            append("\n", 1);
+            break;
+        case output_format::tsv:
+            append(word);
+            append("\t", 1);
+            append_number(count);
+            append("\n", 1);
+            break;
+        case output_format::binary:
+            append_raw(word.size(), 4);
+            append(word);
+            append_raw(static_cast<uint64_t>(count), 8);
+            break;
+    }
+}
+
+void output_writer::begin_section(std::string_view file_name, std::string_view title) {
+    switch (m_format) {
+        case output_format::text:
+            append(title);
+            append(file_name);
+            append("\n", 1);
+            break;
+        case output_format::tsv:
+            append("# ", 2);
+            append(file_name);
+            append("\n", 1);
+            break;
+        case output_format::binary:
+            entry(file_name, -1);
+            break;
+    }
+}
+
+void output_writer::end_section() {
+    if (m_format == output_format::text) {
+        append("\n", 1);
+    }
+}
+
+void output_writer::message(std::string_view line) {
+    if (m_format == output_format::text) {
+        append(line);
+        append("\n", 1);
+    } else {
+        flush();
+        std::cerr << line << std::endl;
+    }
+}
+
+void output_writer::flush() {
+    if (m_used > 0) {
+        std::fwrite(m_buffer.data(), 1, m_used, m_file);
+        m_used = 0;
+    }
+    std::fflush(m_file);
+}
+
+output_format output_writer::format() const {
+    return m_format;
+}
+
+void output_writer::append(const char *data, size_t size) {
+    if (m_used + size > m_buffer.size()) {
+        std::fwrite(m_buffer.data(), 1, m_used, m_file);
+        m_used = 0;
+        if (size > m_buffer.size()) {
+            std::fwrite(data, 1, size, m_file);
+            return;
+        }
+    }
+    std::memcpy(m_buffer.data() + m_used, data, size);
+    m_used += size;
+}
+
+void output_writer::append(std::string_view str) {
+    append(str.data(), str.size());
+}
+
+void output_writer::append_number(long value) {
+    char digits[24];
+    char *end = digits + sizeof(digits);
+    char *pos = end;
+    bool negative = value < 0;
+    unsigned long n = negative ? 0ul - static_cast<unsigned long>(value) : static_cast<unsigned long>(value);
+    while (n >= 100) {
+        pos -= 2;
+        std::memcpy(pos, digit_pairs + (n % 100) * 2, 2);
+        n /= 100;
+    }
+    if (n >= 10) {
+        pos -= 2;
+        std::memcpy(pos, digit_pairs + n * 2, 2);
+    } else {
+        *--pos = static_cast<char>('0' + n);
+    }
+    if (negative) {
+        *--pos = '-';
+    }
+    append(pos, static_cast<size_t>(end - pos));
+}
+
+void output_writer::append_raw(uint64_t value, size_t bytes) {
+    char raw[8];
+    for (size_t i = 0; i < bytes; ++i) {
+        raw[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+    append(raw, bytes);
+}
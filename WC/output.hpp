@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class output_format {
+    text,   //!< "slovo | počet" na řádek
+    tsv,    //!< "slovo<TAB>počet" na řádek
+    binary, //!< hlavička "WCB1", pak záznamy (u32 délka, bajty slova, i64 počet), little-endian
+};
+
+//! Převede jméno formátu (text, tsv, binary) na output_format. Vrací false pro neznámé jméno.
+bool parse_output_format(const std::string &name, output_format &format);
+
+/**
+ * Výstup výsledků přes velký vlastní buffer.
+ *
+ * Záznamy se formátují přímo do bufferu (čísla bez iostreamů) a do souboru
+ * se zapisují po velkých blocích, ne po řádcích. Veškerý výstup na stdout
+ * by měl jít přes jeden writer, jinak se pořadí výpisů může promíchat.
+ */
+class output_writer {
+public:
+    output_writer(std::FILE *file, output_format format, size_t buffer_size = 1 << 20);
+
+    ~output_writer();
+
+    output_writer(const output_writer &) = delete;
+
+    output_writer &operator=(const output_writer &) = delete;
+
+    //! Zapíše jedno slovo s počtem.
+    void entry(std::string_view word, long count);
+
+    /**
+     * Začátek výsledků pro soubor `file_name` (přepínač -s). Textový formát
+     * vypíše nadpis `title` se jménem, TSV řádek "# jméno", binární formát
+     * záznam se jménem souboru a počtem -1.
+     */
+    void begin_section(std::string_view file_name, std::string_view title = "Words for file ");
+
+    //! Konec výsledků pro jeden soubor, v textovém formátu prázdný řádek.
+    void end_section();
+
+    /**
+     * Informativní řádek (chyba, nadpis průběžného výpisu). V textovém
+     * formátu jde do výstupu, v ostatních na stderr, aby nerozbil data.
+     */
+    void message(std::string_view line);
+
+    //! Zapíše obsah bufferu do souboru.
+    void flush();
+
+    output_format format() const;
+
+private:
+    void append(const char *data, size_t size);
+
+    void append(std::string_view str);
+
+    void append_number(long value);
+
+    void append_raw(uint64_t value, size_t bytes);
+
+    std::FILE *m_file;
+    output_format m_format;
+    std::vector<char> m_buffer;
+    size_t m_used = 0;
+};
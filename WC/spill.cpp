@@ -0,0 +1,305 @@
+#include "spill.hpp"
+#include "stream.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <queue>
+#include <utility>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#else
+#include <process.h>
+#define getpid _getpid
+#endif
+
+namespace {
+    //! Velikost jednoho slotu word_table (hash, ukazatel, délka, počet).
+    const size_t bytes_per_slot = 4 * sizeof(uint64_t);
+    const size_t min_slots = 1024;
+    const size_t arena_block_reserve = 64 * 1024;
+    const size_t min_buffer_size = 4 * 1024;
+    const size_t max_buffer_size = 64 * 1024;
+    //! Nejvýše tolik běhů se slévá najednou (kvůli limitu otevřených souborů).
+    const size_t max_merge_fan_in = 512;
+    //! Bitů hashe, podle kterých se vybírá oddíl (spill_partitions == 1 << 6).
+    const unsigned partition_bits = 6;
+
+    size_t floor_pow2(size_t n) {
+        size_t ret = 1;
+        while (ret * 2 <= n) {
+            ret <<= 1;
+        }
+        return ret;
+    }
+
+    //! Oddíl vybírají horní bity hashe, aby nesouvisel s pozicí slotu v tabulce.
+    size_t partition_of(std::string_view word) {
+        return static_cast<size_t>(hash_word(word) >> (64 - partition_bits));
+    }
+
+    //! Záznam běhu: u32 délka slova, bajty slova, i64 počet (nativní pořadí bajtů).
+    void write_record(std::FILE *file, std::string_view word, long count) {
+        auto length = static_cast<uint32_t>(word.size());
+        auto value = static_cast<int64_t>(count);
+        std::fwrite(&length, sizeof(length), 1, file);
+        std::fwrite(word.data(), 1, word.size(), file);
+        std::fwrite(&value, sizeof(value), 1, file);
+    }
+
+    bool read_record(std::FILE *file, std::string &word, long &count) {
+        uint32_t length;
+        int64_t value;
+        if (std::fread(&length, sizeof(length), 1, file) != 1) {
+            return false;
+        }
+        word.resize(length);
+        if (std::fread(&word[0], 1, length, file) != length ||
+            std::fread(&value, sizeof(value), 1, file) != 1) {
+            return false;
+        }
+        count = static_cast<long>(value);
+        return true;
+    }
+
+    bool rewind_run(std::FILE *file) {
+        return std::fflush(file) == 0 && std::fseek(file, 0, SEEK_SET) == 0;
+    }
+}
+
+spilling_counter::run::run(run &&other) noexcept
+        : path(std::move(other.path)), file(other.file) {
+    other.path.clear();
+    other.file = nullptr;
+}
+
+spilling_counter::run &spilling_counter::run::operator=(run &&other) noexcept {
+    // starý soubor zavře a smaže destruktor dočasného objektu
+    run old(std::move(other));
+    std::swap(path, old.path);
+    std::swap(file, old.file);
+    return *this;
+}
+
+spilling_counter::run::~run() {
+    if (file) {
+        std::fclose(file);
+        file = nullptr;
+    }
+    if (!path.empty()) {
+        std::remove(path.c_str());
+        path.clear();
+    }
+}
+
+spilling_counter::spilling_counter(size_t memory_limit, const std::string &temp_dir)
+        : m_arena_limit(std::max(memory_limit / 8 * 3, 2 * arena_block_reserve) - arena_block_reserve),
+          m_buffer_size(std::clamp(memory_limit / 8 / spill_partitions, min_buffer_size, max_buffer_size)),
+          m_merge_fan_in(std::clamp(memory_limit / 2 / m_buffer_size, size_t(2), max_merge_fan_in)),
+          m_table(std::max(min_slots, floor_pow2(memory_limit / 4 / bytes_per_slot))) {
+    std::string dir = temp_dir;
+    if (dir.empty()) {
+        std::error_code error;
+        dir = std::filesystem::temp_directory_path(error).string();
+        if (error) {
+            dir = ".";
+        }
+    }
+    static size_t instances = 0;
+    m_temp_prefix = (std::filesystem::path(dir) /
+                     ("wc-spill-" + std::to_string(getpid()) + "-" + std::to_string(instances++) + "-")).string();
+}
+
+spilling_counter::~spilling_counter() = default;
+
+void spilling_counter::add(std::string_view word) {
+    if (word.empty()) {
+        return;
+    }
+    if (table_full(word.size())) {
+        spill();
+    }
+    m_table.add(word);
+}
+
+size_t spilling_counter::spills() const {
+    return m_spills;
+}
+
+bool spilling_counter::table_full(size_t word_size) const {
+    // pole slotů se nesmí zvětšit, takže vyléváme dřív, než by se zaplnilo z poloviny
+    return (m_table.size() + 1) * 2 > m_table.capacity() || m_table.arena_bytes() + word_size > m_arena_limit;
+}
+
+void spilling_counter::spill() {
+    if (m_partitions.empty() && !create_runs(m_partitions, spill_partitions)) {
+        m_failed = true;
+    }
+    if (!m_failed) {
+        m_table.for_each([this](std::string_view word, long count) {
+            write_record(m_partitions[partition_of(word)].file, word, count);
+        });
+        m_failed = std::any_of(m_partitions.begin(), m_partitions.end(), [](const run &r) {
+            return std::ferror(r.file) != 0;
+        });
+    }
+    m_table.clear();
+    ++m_spills;
+}
+
+bool spilling_counter::create_runs(std::vector<run> &runs, size_t count) {
+    runs.clear();
+    runs.resize(count);
+    for (auto &r : runs) {
+        r.path = m_temp_prefix + std::to_string(m_next_run++);
+        r.file = std::fopen(r.path.c_str(), "w+b");
+        if (!r.file) {
+            return false;
+        }
+        std::setvbuf(r.file, nullptr, _IOFBF, m_buffer_size);
+    }
+    return true;
+}
+
+bool spilling_counter::write_sorted_run(std::vector<run> &sorted_runs) {
+    if (m_table.empty()) {
+        return true;
+    }
+    std::vector<run> sorted;
+    if (!create_runs(sorted, 1)) {
+        return false;
+    }
+    for (const auto &entry : m_table.sorted()) {
+        write_record(sorted[0].file, entry.first, entry.second);
+    }
+    m_table.clear();
+    if (std::ferror(sorted[0].file)) {
+        return false;
+    }
+    sorted_runs.push_back(std::move(sorted[0]));
+    return true;
+}
+
+bool spilling_counter::process_partition(run &partition, std::vector<run> &sorted_runs) {
+    if (!rewind_run(partition.file)) {
+        return false;
+    }
+    m_table.clear();
+    std::string word;
+    long count;
+    while (read_record(partition.file, word, count)) {
+        // oddíl, který se nevejde do limitu, dá víc seřazených běhů; slévání je sečte
+        if (table_full(word.size()) && !write_sorted_run(sorted_runs)) {
+            return false;
+        }
+        m_table.add(word, count);
+    }
+    return !std::ferror(partition.file) && write_sorted_run(sorted_runs);
+}
+
+bool spilling_counter::merge_runs(std::vector<run> &runs,
+                                  const std::function<void(std::string_view, long)> &on_entry) {
+    struct cursor {
+        std::string word;
+        long count = 0;
+    };
+    std::vector<cursor> cursors(runs.size());
+    auto greater = [&cursors](size_t lhs, size_t rhs) {
+        return cursors[lhs].word > cursors[rhs].word;
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(greater)> heap(greater);
+    for (size_t i = 0; i < runs.size(); ++i) {
+        if (!rewind_run(runs[i].file)) {
+            return false;
+        }
+        if (read_record(runs[i].file, cursors[i].word, cursors[i].count)) {
+            heap.push(i);
+        }
+    }
+    bool pending = false;
+    std::string word;
+    long count = 0;
+    while (!heap.empty()) {
+        size_t i = heap.top();
+        heap.pop();
+        if (!pending || cursors[i].word != word) {
+            if (pending) {
+                on_entry(word, count);
+            }
+            word.swap(cursors[i].word);
+            count = 0;
+            pending = true;
+        }
+        count += cursors[i].count;
+        if (read_record(runs[i].file, cursors[i].word, cursors[i].count)) {
+            heap.push(i);
+        }
+    }
+    if (pending) {
+        on_entry(word, count);
+    }
+    return std::none_of(runs.begin(), runs.end(), [](const run &r) {
+        return std::ferror(r.file) != 0;
+    });
+}
+
+bool spilling_counter::finish(const std::function<void(std::string_view, long)> &on_entry) {
+    if (m_partitions.empty() && !m_failed) {
+        for (const auto &entry : m_table.sorted()) {
+            on_entry(entry.first, entry.second);
+        }
+        m_table.clear();
+        return true;
+    }
+
+    spill();
+    std::vector<run> partitions = std::move(m_partitions);
+    m_partitions.clear();
+    if (m_failed) {
+        m_failed = false;
+        return false;
+    }
+    std::vector<run> sorted_runs;
+    for (auto &partition : partitions) {
+        if (!process_partition(partition, sorted_runs)) {
+            return false;
+        }
+        // oddíl smažeme hned, ať disk nedrží data dvakrát
+        partition = run();
+    }
+
+    // Běhů může být víc, než kolik bufferů se vejde do limitu; slijeme je po skupinách.
+    while (sorted_runs.size() > m_merge_fan_in) {
+        std::vector<run> merged;
+        for (size_t first = 0; first < sorted_runs.size(); first += m_merge_fan_in) {
+            std::vector<run> group;
+            size_t last = std::min(sorted_runs.size(), first + m_merge_fan_in);
+            for (size_t i = first; i < last; ++i) {
+                group.push_back(std::move(sorted_runs[i]));
+            }
+            std::vector<run> output;
+            if (!create_runs(output, 1) ||
+                !merge_runs(group, [&output](std::string_view word, long count) {
+                    write_record(output[0].file, word, count);
+                }) ||
+                std::ferror(output[0].file)) {
+                return false;
+            }
+            merged.push_back(std::move(output[0]));
+        }
+        sorted_runs = std::move(merged);
+    }
+    return merge_runs(sorted_runs, on_entry);
+}
+
+bool count_file_spilling(const std::string &file_name, spilling_counter &counter,
+                         const tokenizer_options &options) {
+    return read_in_blocks(file_name, [&counter, &options](const char *begin, const char *end, size_t) {
+        tokenizer tokens(begin, end, options);
+        std::string_view word;
+        while (tokens.next(word)) {
+            counter.add(word);
+        }
+    });
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "tokenizer.hpp"
+#include "word_table.hpp"
+
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Počítání slov s pevně omezenou pamětí pro slovníky větší než RAM.
+ *
+ * Slova se počítají do word_table s předem alokovaným polem slotů, které
+ * se nikdy nezvětšuje. Když se zaplní sloty nebo aréna, rozdělí se celá
+ * tabulka podle horních bitů hashe do `spill_partitions` běhů na disku
+ * a vyprázdní se; stejné slovo tak leží vždy ve stejném oddílu.
+ *
+ * Na konci se oddíly sečtou jeden po druhém do téže tabulky, každý se
+ * seřadí a zapíše jako seřazený běh a seřazené běhy se slijí do jednoho
+ * lexikograficky seřazeného výstupu. Oddíl, který se do limitu nevejde,
+ * dá několik seřazených běhů a stejná slova z nich sečte až slévání.
+ *
+ * Limit pokrývá tabulku, seřazený výpis jednoho oddílu i buffery dočasných
+ * souborů; navíc je jen buffer, ze kterého se čte vstup.
+ */
+class spilling_counter {
+public:
+    //! Počet oddílů, na které se tabulka dělí při každém vylití.
+    static const size_t spill_partitions = 64;
+
+    /**
+     * `memory_limit` je limit paměti v bajtech, dočasné soubory vznikají
+     * v adresáři `temp_dir`.
+     */
+    spilling_counter(size_t memory_limit, const std::string &temp_dir);
+
+    //! Smaže všechny dočasné soubory, které ještě existují.
+    ~spilling_counter();
+
+    spilling_counter(const spilling_counter &) = delete;
+
+    spilling_counter &operator=(const spilling_counter &) = delete;
+
+    //! Přičte jeden výskyt slova. Prázdná slova ignoruje.
+    void add(std::string_view word);
+
+    /**
+     * Zavolá `on_entry(word, count)` pro všechna slova seřazená podle slova
+     * a vyprázdní počítadlo. Vrací false, pokud se nepodařilo zapsat nebo
+     * přečíst některý dočasný soubor (a pak `on_entry` nemusí dostat nic).
+     */
+    bool finish(const std::function<void(std::string_view, long)> &on_entry);
+
+    //! Kolikrát se tabulka vylila na disk.
+    size_t spills() const;
+
+private:
+    //! Dočasný soubor s během záznamů; při zničení se zavře a smaže.
+    struct run {
+        std::string path;
+        std::FILE *file = nullptr;
+
+        run() = default;
+
+        run(run &&other) noexcept;
+
+        run &operator=(run &&other) noexcept;
+
+        ~run();
+    };
+
+    bool table_full(size_t word_size) const;
+
+    void spill();
+
+    bool create_runs(std::vector<run> &runs, size_t count);
+
+    bool write_sorted_run(std::vector<run> &sorted_runs);
+
+    bool process_partition(run &partition, std::vector<run> &sorted_runs);
+
+    bool merge_runs(std::vector<run> &runs, const std::function<void(std::string_view, long)> &on_entry);
+
+    size_t m_arena_limit;
+    size_t m_buffer_size;
+    size_t m_merge_fan_in;
+    std::string m_temp_prefix;
+    size_t m_next_run = 0;
+    size_t m_spills = 0;
+    bool m_failed = false;
+    word_table m_table;
+    std::vector<run> m_partitions;
+};
+
+/**
+ * Spočítá slova ze souboru `file_name` (nebo ze standardního vstupu pro "-")
+ * do `counter`. Soubor se čte po blocích, ne přes mmap, aby do paměti
+ * procesu nepřibývaly stránky souboru. Vrací false, pokud soubor nešel otevřít.
+ */
+bool count_file_spilling(const std::string &file_name, spilling_counter &counter,
+                         const tokenizer_options &options = {});
@@ -0,0 +1,95 @@
+#include "stats.hpp"
+
+#include <algorithm>
+#include <ctime>
+
+const char *phase_name(phase p) {
+    switch (p) {
+        case phase::read:
+            return "read";
+        case phase::tokenize:
+            return "tokenize";
+        case phase::count:
+            return "count";
+        case phase::merge:
+            return "merge";
+        case phase::print:
+            return "print";
+    }
+    return "?";
+}
+
+double thread_cpu_seconds() {
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) / 1e9;
+#else
+    // bez časovače vlákna měříme čas celého procesu
+    return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+#endif
+}
+
+void run_stats::merge(const run_stats &other) {
+    bytes_read += other.bytes_read;
+    words += other.words;
+    distinct += other.distinct;
+    slots += other.slots;
+    probe_total += other.probe_total;
+    longest_probe = std::max(longest_probe, other.longest_probe);
+    for (size_t i = 0; i < phase_count; ++i) {
+        phases[i].wall += other.phases[i].wall;
+        phases[i].cpu += other.phases[i].cpu;
+    }
+}
+
+void run_stats::add_table(const word_table &words) {
+    auto probes = words.probes();
+    distinct += words.size();
+    slots += words.capacity();
+    probe_total += probes.total;
+    longest_probe = std::max(longest_probe, probes.longest);
+}
+
+phase_timer::phase_timer(run_stats *stats, phase p) : m_stats(stats), m_phase(p) {
+    if (m_stats) {
+        m_wall_start = std::chrono::steady_clock::now();
+        m_cpu_start = thread_cpu_seconds();
+    }
+}
+
+phase_timer::~phase_timer() {
+    stop();
+}
+
+void phase_timer::stop() {
+    if (!m_stats) {
+        return;
+    }
+    auto &time = m_stats->phases[static_cast<size_t>(m_phase)];
+    time.wall += std::chrono::duration<double>(std::chrono::steady_clock::now() - m_wall_start).count();
+    time.cpu += thread_cpu_seconds() - m_cpu_start;
+    m_stats = nullptr;
+}
+
+void print_stats(std::FILE *file, const run_stats &stats, double total_wall) {
+    std::fprintf(file, "bytes read       %llu\n", static_cast<unsigned long long>(stats.bytes_read));
+    std::fprintf(file, "words tokenized  %llu\n", static_cast<unsigned long long>(stats.words));
+    std::fprintf(file, "distinct words   %llu\n", static_cast<unsigned long long>(stats.distinct));
+    if (stats.slots) {
+        std::fprintf(file, "table load       %.3f (%llu slots)\n",
+                     static_cast<double>(stats.distinct) / static_cast<double>(stats.slots),
+                     static_cast<unsigned long long>(stats.slots));
+    }
+    if (stats.distinct) {
+        std::fprintf(file, "probe length     avg %.3f, max %zu\n",
+                     static_cast<double>(stats.probe_total) / static_cast<double>(stats.distinct),
+                     stats.longest_probe);
+    }
+    std::fprintf(file, "%-16s %10s %10s\n", "phase", "wall [s]", "cpu [s]");
+    for (size_t i = 0; i < phase_count; ++i) {
+        std::fprintf(file, "%-16s %10.3f %10.3f\n", phase_name(static_cast<phase>(i)),
+                     stats.phases[i].wall, stats.phases[i].cpu);
+    }
+    std::fprintf(file, "%-16s %10.3f\n", "total", total_wall);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "word_table.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+//! Fáze běhu, pro které --stats měří čas.
+enum class phase {
+    read,     //!< otevření souboru a načtení jeho stránek
+    tokenize, //!< hledání a ořezávání slov
+    count,    //!< vkládání slov do tabulky
+    merge,    //!< slučování tabulek jednotlivých vláken
+    print,    //!< řazení a výpis
+};
+
+static const size_t phase_count = 5;
+
+//! Jméno fáze pro výpis.
+const char *phase_name(phase p);
+
+//! Čas procesoru spotřebovaný aktuálním vláknem v sekundách.
+double thread_cpu_seconds();
+
+struct phase_time {
+    double wall = 0; //!< reálný čas (u paralelních fází součet přes vlákna)
+    double cpu = 0;  //!< čas procesoru (součet přes vlákna)
+};
+
+/**
+ * Statistiky jednoho běhu pro přepínač --stats. Každé vlákno plní vlastní
+ * instanci a volající je po doběhnutí vláken sečte přes merge(), takže
+ * se za běhu nic nesynchronizuje.
+ */
+struct run_stats {
+    uint64_t bytes_read = 0;
+    uint64_t words = 0;         //!< počet slov z tokenizéru (včetně opakování)
+    uint64_t distinct = 0;      //!< součet různých slov přes započítané tabulky
+    uint64_t slots = 0;         //!< součet kapacit započítaných tabulek
+    uint64_t probe_total = 0;   //!< součet délek sondování přes všechna různá slova
+    size_t longest_probe = 0;
+    std::array<phase_time, phase_count> phases;
+
+    void merge(const run_stats &other);
+
+    //! Přidá velikost, zaplnění a délky sondování tabulky `words`.
+    void add_table(const word_table &words);
+};
+
+/**
+ * Změří čas fáze na aktuálním vlákně od vytvoření do stop() (nebo do
+ * zničení) a přičte ho do `stats`. S `stats` == nullptr nic neměří.
+ */
+class phase_timer {
+public:
+    phase_timer(run_stats *stats, phase p);
+
+    ~phase_timer();
+
+    phase_timer(const phase_timer &) = delete;
+
+    phase_timer &operator=(const phase_timer &) = delete;
+
+    void stop();
+
+private:
+    run_stats *m_stats;
+    phase m_phase;
+    std::chrono::steady_clock::time_point m_wall_start;
+    double m_cpu_start = 0;
+};
+
+//! Vypíše statistiky jako čitelnou tabulku; `total_wall` je celkový reálný čas běhu.
+void print_stats(std::FILE *file, const run_stats &stats, double total_wall);
@@ -0,0 +1,137 @@
+#include "stream.hpp"
+#include "decompress.hpp"
+#include "tokenizer.hpp"
+
+#include <chrono>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+namespace {
+    const size_t stream_block_size = 4 << 20;
+
+    /**
+     * Přečte nejvýše `size` bajtů. Na POSIX systémech vrátí hned to, co je
+     * k dispozici (důležité pro rouru s živým logem), jinak čeká na plný blok.
+     */
+    long read_some(std::FILE *file, char *buffer, size_t size) {
+#if !defined(_WIN32)
+        while (true) {
+            ssize_t n = ::read(fileno(file), buffer, size);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            return static_cast<long>(n);
+        }
+#else
+        return static_cast<long>(std::fread(buffer, 1, size, file));
+#endif
+    }
+
+    void count_block(const char *begin, const char *end, space_saving &counters,
+                     const tokenizer_options &options, hyperloglog *distinct) {
+        tokenizer tokens(begin, end, options);
+        std::string_view word;
+        while (tokens.next(word)) {
+            counters.add(word);
+            if (distinct) {
+                distinct->add(word);
+            }
+        }
+    }
+
+    /**
+     * Společná část read_in_blocks: `read(buffer, size)` vrací počet
+     * přečtených bajtů, 0 na konci a záporné číslo při chybě.
+     */
+    template <typename Read>
+    bool split_blocks(Read read, const std::function<void(const char *, const char *, size_t)> &on_block) {
+        std::vector<char> buffer(stream_block_size);
+        size_t filled = 0;
+        size_t total_bytes = 0;
+        long n;
+        while ((n = read(buffer.data() + filled, buffer.size() - filled)) > 0) {
+            filled += static_cast<size_t>(n);
+            total_bytes += static_cast<size_t>(n);
+
+            // nedokončené slovo na konci bloku necháme na další čtení
+            size_t cut = filled;
+            while (cut > 0 && !is_separator(buffer[cut - 1])) {
+                --cut;
+            }
+            if (cut == 0 && filled == buffer.size()) {
+                // slovo delší než celý blok, počítáme ho rozdělené
+                cut = filled;
+            }
+            on_block(buffer.data(), buffer.data() + cut, total_bytes);
+            std::memmove(buffer.data(), buffer.data() + cut, filled - cut);
+            filled -= cut;
+        }
+        on_block(buffer.data(), buffer.data() + filled, total_bytes);
+        return n == 0;
+    }
+}
+
+bool read_in_blocks(const std::string &file_name,
+                    const std::function<void(const char *, const char *, size_t)> &on_block) {
+    compression kind = compression_of(file_name);
+    if (kind != compression::none) {
+        decompressing_reader reader(file_name, kind);
+        if (!reader.is_open()) {
+            return false;
+        }
+        return split_blocks([&reader](char *buffer, size_t size) { return reader.read(buffer, size); }, on_block);
+    }
+
+    const bool is_stdin = file_name == stdin_name;
+    std::FILE *file = is_stdin ? stdin : std::fopen(file_name.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    bool ok = split_blocks([file](char *buffer, size_t size) { return read_some(file, buffer, size); }, on_block);
+    if (!is_stdin) {
+        std::fclose(file);
+    }
+    return ok;
+}
+
+bool count_stream(const std::string &file_name, space_saving &counters,
+                  const stream_options &options, output_writer &out, hyperloglog *distinct) {
+    using clock = std::chrono::steady_clock;
+    size_t next_snapshot_bytes = options.snapshot_bytes;
+    auto next_snapshot_time = clock::now() + std::chrono::seconds(options.snapshot_seconds);
+
+    return read_in_blocks(file_name, [&](const char *begin, const char *end, size_t total_bytes) {
+        count_block(begin, end, counters, options.tokens, distinct);
+
+        bool snapshot = false;
+        if (options.snapshot_bytes && total_bytes >= next_snapshot_bytes) {
+            snapshot = true;
+            while (next_snapshot_bytes <= total_bytes) {
+                next_snapshot_bytes += options.snapshot_bytes;
+            }
+        }
+        if (options.snapshot_seconds && clock::now() >= next_snapshot_time) {
+            snapshot = true;
+            next_snapshot_time = clock::now() + std::chrono::seconds(options.snapshot_seconds);
+        }
+        if (snapshot) {
+            out.message("Top " + std::to_string(options.top_k) + " words after " +
+                        std::to_string(total_bytes) + " bytes");
+            print_top(counters, options.top_k, out);
+            out.end_section();
+            out.flush();
+        }
+    });
+}
+
+void print_top(const space_saving &counters, size_t k, output_writer &out) {
+    for (const auto &item : counters.top(k)) {
+        out.entry(item.word, item.count);
+    }
+}
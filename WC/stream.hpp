@@ -0,0 +1,48 @@
+#pragma once
+
+#include "heavy_hitters.hpp"
+#include "hyperloglog.hpp"
+#include "output.hpp"
+#include "tokenizer.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+struct stream_options {
+    size_t top_k = 10;             //!< kolik nejčastějších slov vypisovat
+    size_t capacity = 10000;       //!< počet čítačů Space-Saving
+    size_t snapshot_bytes = 0;     //!< průběžný výpis po každých N bajtech (0 = vypnuto)
+    unsigned snapshot_seconds = 0; //!< průběžný výpis po každých N sekundách (0 = vypnuto)
+    tokenizer_options tokens;
+};
+
+//! Jméno souboru, které označuje standardní vstup.
+static const char stdin_name[] = "-";
+
+/**
+ * Čte soubor `file_name` (nebo standardní vstup, pokud je `file_name` "-")
+ * po blocích 4 MB a každý přečtený úsek předá `on_block(begin, end, total)`,
+ * kde `total` je počet dosud přečtených bajtů. Úseky končí na oddělovači,
+ * nedokončené slovo se přenese do dalšího čtení (jen slovo delší než celý
+ * blok se rozdělí). Soubory .gz a .zst se rozbalují na vlastním vlákně
+ * (viz decompressing_reader). Vrací false, pokud soubor nešel otevřít nebo
+ * přečíst celý (chyba čtení, poškozená komprimovaná data).
+ */
+bool read_in_blocks(const std::string &file_name,
+                    const std::function<void(const char *, const char *, size_t)> &on_block);
+
+/**
+ * Čte soubor `file_name` (nebo standardní vstup, pokud je `file_name` "-")
+ * po velkých blocích a přidává slova do `counters`. Paměť je omezená
+ * velikostí bloku a kapacitou `counters`, nezávisle na délce vstupu.
+ *
+ * Podle `options` průběžně vypisuje aktuálních top-K slov do `out`.
+ * Pokud je zadaný `distinct`, přidává do něj slova pro odhad počtu různých.
+ * Vrací false, pokud soubor nešel otevřít.
+ */
+bool count_stream(const std::string &file_name, space_saving &counters,
+                  const stream_options &options, output_writer &out, hyperloglog *distinct = nullptr);
+
+//! Vypíše `k` nejčastějších slov.
+void print_top(const space_saving &counters, size_t k, output_writer &out);
@@ -0,0 +1,87 @@
+#include "../classify.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+/*
+    Ověří, že všechny implementace classify_block dostupné na tomto procesoru
+    dávají stejné masky jako skalární. Testuje každou hodnotu bajtu na každé
+    pozici bloku a náhodné bloky na nezarovnaných adresách, včetně konce
+    vstupu doplněného mezerami stejně jako v tokenizer::load_block.
+*/
+
+namespace {
+    size_t failures = 0;
+
+    bool operator==(const block_masks &a, const block_masks &b) {
+        return a.separator == b.separator && a.word_char == b.word_char && a.upper == b.upper && a.high == b.high;
+    }
+
+    void check_block(const classifier_variant &variant, const char *p, const std::string &what) {
+        block_masks expected = classify_block_scalar(p);
+        block_masks actual = variant.fn(p);
+        if (!(actual == expected)) {
+            if (++failures <= 10) {
+                std::cerr << variant.name << ": masks differ for " << what << std::hex
+                          << "\n  separator " << actual.separator << " != " << expected.separator
+                          << "\n  word_char " << actual.word_char << " != " << expected.word_char
+                          << "\n  upper     " << actual.upper << " != " << expected.upper
+                          << "\n  high      " << actual.high << " != " << expected.high << std::dec << "\n";
+            }
+        }
+    }
+
+    void check_all_bytes(const classifier_variant &variant) {
+        char block[classify_block_size];
+        for (unsigned value = 0; value < 256; ++value) {
+            // hodnota na jedné pozici mezi písmeny i mezi mezerami
+            for (char background : {'a', ' '}) {
+                for (size_t pos = 0; pos < classify_block_size; ++pos) {
+                    std::fill(std::begin(block), std::end(block), background);
+                    block[pos] = static_cast<char>(value);
+                    check_block(variant, block,
+                                "byte " + std::to_string(value) + " at position " + std::to_string(pos));
+                }
+            }
+            // celý blok stejné hodnoty
+            std::fill(std::begin(block), std::end(block), static_cast<char>(value));
+            check_block(variant, block, "block of byte " + std::to_string(value));
+        }
+    }
+
+    void check_random(const classifier_variant &variant) {
+        std::mt19937_64 gen(42);
+        std::uniform_int_distribution<int> byte(0, 255);
+        // mix s větším podílem ASCII, aby se střídaly všechny třídy
+        const std::string ascii = " \n\taz09AZ_-.,'@[`{\x7f";
+        std::vector<char> buffer(4 * classify_block_size + 64);
+        for (size_t round = 0; round < 2000; ++round) {
+            for (auto &c : buffer) {
+                c = (byte(gen) & 1) ? static_cast<char>(byte(gen)) : ascii[byte(gen) % ascii.size()];
+            }
+            size_t offset = round % 64;
+            check_block(variant, buffer.data() + offset, "random block at offset " + std::to_string(offset));
+
+            // konec vstupu kratší než blok
+            size_t tail_size = round % classify_block_size;
+            char tail[classify_block_size];
+            std::fill(std::begin(tail), std::end(tail), ' ');
+            std::memcpy(tail, buffer.data() + offset + classify_block_size, tail_size);
+            check_block(variant, tail, "tail of " + std::to_string(tail_size) + " bytes");
+        }
+    }
+}
+
+int main() {
+    for (const auto &variant : classifier_variants()) {
+        size_t before = failures;
+        check_all_bytes(variant);
+        check_random(variant);
+        std::cout << variant.name << ": " << (failures == before ? "ok" : "FAILED") << "\n";
+    }
+    return failures == 0 ? 0 : 1;
+}
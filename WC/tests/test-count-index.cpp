@@ -0,0 +1,97 @@
+#include "../count_index.hpp"
+#include "../counter.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+/*
+    Zapíše index z jednoho souboru, přičte do něj druhý a výsledek porovná
+    s obyčejným spočítáním obou souborů. Totéž pro aktualizaci prázdného
+    souboru (jako po `touch`) a nakonec ověří, že poškozený index se odmítne
+    a aktualizace ho nechá beze změny.
+*/
+
+namespace {
+    size_t failures = 0;
+
+    void check(bool condition, const std::string &what) {
+        if (!condition) {
+            ++failures;
+            std::cerr << "FAILED: " << what << "\n";
+        }
+    }
+
+    void write_file(const std::string &file_name, const std::string &content) {
+        std::ofstream(file_name, std::ios::binary) << content;
+    }
+
+    std::string read_file(const std::string &file_name) {
+        std::ifstream in(file_name, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    word_table count_file(const std::string &file_name) {
+        word_table words;
+        check(count_words_in_file(file_name, 1, words), "count " + file_name);
+        return words;
+    }
+
+    //! Porovná celý obsah indexu s tabulkou spočítanou bez indexu.
+    void check_index(const std::string &index_name, const word_table &expected) {
+        count_index index(index_name);
+        check(index.is_valid(), index_name + " is a valid index");
+        if (!index.is_valid()) {
+            return;
+        }
+        auto sorted = expected.sorted();
+        check(index.size() == sorted.size(), index_name + " has " + std::to_string(sorted.size()) + " words");
+        for (size_t i = 0; i < index.size() && i < sorted.size(); ++i) {
+            check(index.word(i) == sorted[i].first && index.count(i) == sorted[i].second,
+                  index_name + " entry " + std::to_string(i) + " is " + std::string(sorted[i].first));
+            check(index.find(sorted[i].first) == sorted[i].second, index_name + " finds " + std::string(sorted[i].first));
+        }
+        check(index.find("missing-word") == 0, index_name + " does not find a missing word");
+    }
+}
+
+int main() {
+    auto dir = std::filesystem::temp_directory_path() / "wc-test-count-index";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    std::string first = (dir / "first.txt").string();
+    std::string second = (dir / "second.txt").string();
+    write_file(first, "the quick brown fox jumps over the lazy dog\nThe end, the END.\n");
+    write_file(second, "a lazy fox\tand a quick cat\n\nzebra apple the dog dog\n");
+
+    word_table expected;
+    check(count_words_in_file(first, 1, expected), "count " + first);
+    check(count_words_in_file(second, 1, expected), "count " + second);
+
+    // nový index z prvního souboru, pak přičtení druhého
+    std::string written = (dir / "written.wci").string();
+    check(write_index(written, count_file(first).sorted()), "write " + written);
+    check(merge_into_index(written, count_file(second)), "update " + written);
+    check_index(written, expected);
+
+    // prázdný soubor se aktualizuje jako chybějící index
+    std::string empty = (dir / "empty.wci").string();
+    write_file(empty, "");
+    check(merge_into_index(empty, count_file(first)), "update empty " + empty);
+    check(merge_into_index(empty, count_file(second)), "update " + empty);
+    check_index(empty, expected);
+
+    // useknutý index je neplatný a aktualizace ho nepřepíše
+    std::string truncated = (dir / "truncated.wci").string();
+    std::string content = read_file(written);
+    content.pop_back();
+    write_file(truncated, content);
+    check(!count_index(truncated).is_valid(), truncated + " is rejected");
+    check(!merge_into_index(truncated, count_file(first)), "update of " + truncated + " fails");
+    check(read_file(truncated) == content, truncated + " is left unchanged");
+
+    std::filesystem::remove_all(dir);
+    std::cout << (failures == 0 ? "ok" : "FAILED") << "\n";
+    return failures == 0 ? 0 : 1;
+}
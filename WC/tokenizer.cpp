@@ -0,0 +1,130 @@
+#include "tokenizer.hpp"
+#include "utf8.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+    constexpr std::array<unsigned char, 256> make_char_classes() {
+        std::array<unsigned char, 256> ret{};
+        ret[static_cast<unsigned char>(' ')] = char_separator;
+        ret[static_cast<unsigned char>('\n')] = char_separator;
+        ret[static_cast<unsigned char>('\t')] = char_separator;
+        for (int c = '0'; c <= '9'; ++c) {
+            ret[c] = char_alnum;
+        }
+        for (int c = 'a'; c <= 'z'; ++c) {
+            ret[c] = char_alnum;
+            ret[c - 'a' + 'A'] = char_alnum;
+        }
+        return ret;
+    }
+}
+
+constexpr std::array<unsigned char, 256> char_classes = make_char_classes();
+
+std::string_view trim_word(std::string_view word) {
+    for (char c : word) {
+        if (static_cast<unsigned char>(c) >= 0x80) {
+            return trim_word_utf8(word);
+        }
+    }
+    size_t first = 0;
+    size_t last = word.size();
+    while (first < last && !is_word_char(word[first])) {
+        ++first;
+    }
+    while (last > first && !is_word_char(word[last - 1])) {
+        --last;
+    }
+    return word.substr(first, last - first);
+}
+
+tokenizer::tokenizer(const char *begin, const char *end, const tokenizer_options &options)
+        : m_begin(begin), m_size(static_cast<size_t>(end - begin)), m_options(options) {
+    load_block(0);
+}
+
+std::string_view tokenizer::normalize(std::string_view raw) {
+    std::string_view word = trim_word(raw);
+    if (m_options.fold_case && !word.empty()) {
+        return fold_word(word, m_scratch);
+    }
+    return word;
+}
+
+void tokenizer::load_block(size_t offset) {
+    m_block = offset;
+    if (offset + classify_block_size <= m_size) {
+        m_masks = classify_block(m_begin + offset);
+    } else {
+        // konec vstupu doplníme mezerami, aby za ním vždy byl oddělovač
+        char tail[classify_block_size];
+        std::fill(std::begin(tail), std::end(tail), ' ');
+        if (offset < m_size) {
+            std::copy(m_begin + offset, m_begin + m_size, tail);
+        }
+        m_masks = classify_block(tail);
+    }
+}
+
+bool tokenizer::next(std::string_view &word) {
+    while (m_pos < m_size) {
+        // začátek slova: první bajt, který není oddělovač
+        uint64_t candidates = ~m_masks.separator & (~0ull << (m_pos - m_block));
+        if (!candidates) {
+            m_pos = m_block + classify_block_size;
+            if (m_pos < m_size) {
+                load_block(m_pos);
+            }
+            continue;
+        }
+        m_pos = m_block + lowest_bit(candidates);
+        if (m_pos >= m_size) {
+            return false;
+        }
+        const size_t start = m_pos;
+        const size_t start_block = m_block;
+
+        // konec slova: první oddělovač za začátkem
+        uint64_t separators;
+        while (!(separators = m_masks.separator & (~0ull << (m_pos - m_block)))) {
+            m_pos = m_block + classify_block_size;
+            if (m_pos >= m_size) {
+                break;
+            }
+            load_block(m_pos);
+        }
+        if (separators) {
+            m_pos = m_block + lowest_bit(separators);
+        }
+        const size_t end = std::min(m_pos, m_size);
+
+        if (start_block == m_block && separators) {
+            uint64_t range = (~0ull << (start - m_block)) & ((1ull << (end - m_block)) - 1);
+            if (!(m_masks.high & range)) {
+                // čisté ASCII slovo celé v jednom bloku, ořízneme ho přímo z masky
+                uint64_t chars = m_masks.word_char & range;
+                if (!chars) {
+                    continue;
+                }
+                size_t first = lowest_bit(chars);
+                size_t last = highest_bit(chars);
+                word = std::string_view(m_begin + m_block + first, last - first + 1);
+                if (m_options.fold_case && (m_masks.upper & range)) {
+                    word = fold_word(word, m_scratch);
+                }
+                return true;
+            }
+        }
+        word = normalize(std::string_view(m_begin + start, end - start));
+        if (!word.empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t tokenizer::position() const {
+    return std::min(m_pos, m_size);
+}
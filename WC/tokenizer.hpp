@@ -0,0 +1,79 @@
+#pragma once
+
+#include "classify.hpp"
+
+#include <array>
+#include <string>
+#include <string_view>
+
+enum char_class : unsigned char {
+    char_other = 0,
+    char_separator = 1,
+    char_alnum = 2,
+};
+
+//! Třída každého bajtu, viz char_class.
+extern const std::array<unsigned char, 256> char_classes;
+
+//! Vrací true pro znaky, které oddělují slova (mezera, nový řádek, tabulátor).
+inline bool is_separator(char c) {
+    return char_classes[static_cast<unsigned char>(c)] == char_separator;
+}
+
+//! Vrací true pro alfanumerické ASCII znaky.
+inline bool is_word_char(char c) {
+    return char_classes[static_cast<unsigned char>(c)] == char_alnum;
+}
+
+/**
+ * Odřízne ze začátku a konce slova všechny nealfanumerické znaky. Slovo
+ * s bajty >= 0x80 se ořezává po znacích UTF-8 (viz is_unicode_word_char).
+ * Nic nekopíruje, vrací pohled do původního slova (případně prázdný).
+ */
+std::string_view trim_word(std::string_view word);
+
+struct tokenizer_options {
+    bool fold_case = false; //!< převádět slova na malá písmena (i mimo ASCII)
+};
+
+/**
+ * Rozděluje blok paměti na slova. Vrácená slova jsou pohledy přímo do
+ * bloku, už očištěné pomocí trim_word; prázdná slova se přeskakují.
+ * Blok musí zůstat platný po celou dobu používání vrácených pohledů.
+ *
+ * Vstup se klasifikuje po 64 bajtech (classify_block) a hranice slov se
+ * hledají v bitových maskách, ne znak po znaku. Pouze slova, která
+ * obsahují bajty >= 0x80 (nebo velká písmena při fold_case), se zpracují
+ * pomalou cestou přes dekodér UTF-8.
+ *
+ * Při fold_case může vrácený pohled ukazovat do vnitřního bufferu, který
+ * se dalším voláním next přepíše.
+ */
+class tokenizer {
+public:
+    tokenizer(const char *begin, const char *end, const tokenizer_options &options = tokenizer_options());
+
+    //! Uloží další slovo do `word`. Vrací false, pokud už žádné není.
+    bool next(std::string_view &word);
+
+    /**
+     * Offset (od začátku bloku) hned za posledním vráceným slovem, včetně
+     * odříznutých znaků. Podle něj se pozná, ve kterém úseku slovo leží.
+     */
+    size_t position() const;
+
+private:
+    //! Načte masky pro blok začínající na offsetu `offset`.
+    void load_block(size_t offset);
+
+    //! Pomalá cesta: ořízne (a případně převede) slovo mimo čisté ASCII.
+    std::string_view normalize(std::string_view raw);
+
+    const char *m_begin;
+    size_t m_size;
+    size_t m_pos = 0;
+    size_t m_block = 0;
+    block_masks m_masks;
+    tokenizer_options m_options;
+    std::string m_scratch;
+};
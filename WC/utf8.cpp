@@ -0,0 +1,278 @@
+#include "utf8.hpp"
+#include "tokenizer.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+    struct code_range {
+        char32_t first;
+        char32_t last;
+    };
+
+    //! Seřazené rozsahy znaků mimo ASCII, které nepatří do slova.
+    const code_range non_word_ranges[] = {
+            {0x0080, 0x00A9}, // řídicí znaky C1, NBSP, ¡¢£¤¥¦§¨©
+            {0x00AB, 0x00B4}, // «¬ ®¯°±²³´
+            {0x00B6, 0x00B9}, // ¶·¸¹
+            {0x00BB, 0x00BF}, // »¼½¾¿
+            {0x00D7, 0x00D7}, // ×
+            {0x00F7, 0x00F7}, // ÷
+            {0x037E, 0x037E}, // řecký otazník
+            {0x0387, 0x0387},
+            {0x055A, 0x055F}, // arménská interpunkce
+            {0x0589, 0x058A},
+            {0x05BE, 0x05BE},
+            {0x05C0, 0x05C0},
+            {0x05C3, 0x05C3},
+            {0x05F3, 0x05F4},
+            {0x060C, 0x060D}, // arabská interpunkce
+            {0x061B, 0x061B},
+            {0x061F, 0x061F},
+            {0x066A, 0x066D},
+            {0x06D4, 0x06D4},
+            {0x0964, 0x0965}, // dévanágarí danda
+            {0x0970, 0x0970},
+            {0x0E4F, 0x0E4F},
+            {0x0E5A, 0x0E5B},
+            {0x2000, 0x206F}, // General Punctuation (mezery, pomlčky, uvozovky, …)
+            {0x20A0, 0x20CF}, // měny
+            {0x2190, 0x2BFF}, // šipky, matematické a technické symboly, rámečky, dingbats
+            {0x2E00, 0x2E7F}, // Supplemental Punctuation
+            {0x3000, 0x3004}, // CJK mezera a interpunkce
+            {0x3008, 0x3020},
+            {0x3030, 0x3030},
+            {0x303D, 0x303D},
+            {0xE000, 0xF8FF}, // Private Use Area
+            {0xFE10, 0xFE1F},
+            {0xFE30, 0xFE6F}, // CJK compatibility a small form variants
+            {0xFEFF, 0xFEFF}, // BOM
+            {0xFF00, 0xFF0F}, // fullwidth interpunkce
+            {0xFF1A, 0xFF20},
+            {0xFF3B, 0xFF40},
+            {0xFF5B, 0xFF65},
+            {0xFFF0, 0xFFFF}, // Specials, včetně U+FFFD
+            {0x1F000, 0x1FAFF}, // emoji a symboly
+    };
+
+    bool in_range(char32_t cp, char32_t first, char32_t last) {
+        return cp >= first && cp <= last;
+    }
+
+    //! Ve velkém bloku jsou velká písmena na sudých a malá na lichých pozicích.
+    char32_t fold_even_odd(char32_t cp) {
+        return (cp & 1) ? cp : cp + 1;
+    }
+
+    //! Ve velkém bloku jsou velká písmena na lichých a malá na sudých pozicích.
+    char32_t fold_odd_even(char32_t cp) {
+        return (cp & 1) ? cp + 1 : cp;
+    }
+
+    bool is_continuation(char c) {
+        return (static_cast<unsigned char>(c) & 0xC0) == 0x80;
+    }
+
+    bool has_high_bytes(std::string_view word) {
+        return std::any_of(word.begin(), word.end(), [](char c) {
+            return static_cast<unsigned char>(c) >= 0x80;
+        });
+    }
+}
+
+size_t decode_utf8(const char *p, const char *end, char32_t &cp) {
+    auto b0 = static_cast<unsigned char>(p[0]);
+    size_t length;
+    char32_t min;
+    if (b0 < 0x80) {
+        cp = b0;
+        return 1;
+    } else if ((b0 & 0xE0) == 0xC0) {
+        length = 2;
+        cp = b0 & 0x1F;
+        min = 0x80;
+    } else if ((b0 & 0xF0) == 0xE0) {
+        length = 3;
+        cp = b0 & 0x0F;
+        min = 0x800;
+    } else if ((b0 & 0xF8) == 0xF0) {
+        length = 4;
+        cp = b0 & 0x07;
+        min = 0x10000;
+    } else {
+        cp = invalid_code_point;
+        return 1;
+    }
+    if (static_cast<size_t>(end - p) < length) {
+        cp = invalid_code_point;
+        return 1;
+    }
+    for (size_t i = 1; i < length; ++i) {
+        if (!is_continuation(p[i])) {
+            cp = invalid_code_point;
+            return 1;
+        }
+        cp = (cp << 6) | (static_cast<unsigned char>(p[i]) & 0x3F);
+    }
+    // overlong zápisy, surrogaty a kódy za U+10FFFF jsou neplatné
+    if (cp < min || cp > 0x10FFFF || in_range(cp, 0xD800, 0xDFFF)) {
+        cp = invalid_code_point;
+        return 1;
+    }
+    return length;
+}
+
+void encode_utf8(char32_t cp, std::string &out) {
+    if (cp < 0x80) {
+        out.push_back(static_cast<char>(cp));
+    } else if (cp < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+}
+
+bool is_unicode_word_char(char32_t cp) {
+    if (cp < 0x80) {
+        return is_word_char(static_cast<char>(cp));
+    }
+    auto it = std::upper_bound(std::begin(non_word_ranges), std::end(non_word_ranges), cp,
+                               [](char32_t value, const code_range &range) {
+                                   return value < range.first;
+                               });
+    return it == std::begin(non_word_ranges) || cp > std::prev(it)->last;
+}
+
+char32_t fold_case(char32_t cp) {
+    if (cp < 0x80) {
+        return in_range(cp, 'A', 'Z') ? cp + 0x20 : cp;
+    }
+    if (in_range(cp, 0x00C0, 0x00DE) && cp != 0x00D7) {
+        return cp + 0x20;
+    }
+    if (cp < 0x0100) {
+        return cp;
+    }
+    if (cp < 0x0180) {
+        if (cp == 0x0130 || cp == 0x0131 || cp == 0x0138 || cp == 0x0149) {
+            return cp;
+        }
+        if (cp == 0x0178) {
+            return 0x00FF;
+        }
+        if (cp == 0x017F) {
+            return 's';
+        }
+        if (in_range(cp, 0x0139, 0x0148) || in_range(cp, 0x0179, 0x017E)) {
+            return fold_odd_even(cp);
+        }
+        return fold_even_odd(cp);
+    }
+    if (in_range(cp, 0x0370, 0x03FF)) {
+        if (in_range(cp, 0x0391, 0x03AB) && cp != 0x03A2) {
+            return cp + 0x20;
+        }
+        switch (cp) {
+            case 0x0386:
+                return 0x03AC;
+            case 0x0388:
+            case 0x0389:
+            case 0x038A:
+                return cp + 0x25;
+            case 0x038C:
+                return 0x03CC;
+            case 0x038E:
+            case 0x038F:
+                return cp + 0x3F;
+            case 0x03C2:
+                return 0x03C3;
+            default:
+                return cp;
+        }
+    }
+    if (in_range(cp, 0x0400, 0x040F)) {
+        return cp + 0x50;
+    }
+    if (in_range(cp, 0x0410, 0x042F)) {
+        return cp + 0x20;
+    }
+    if (in_range(cp, 0x0460, 0x0481) || in_range(cp, 0x048A, 0x04BF)) {
+        return fold_even_odd(cp);
+    }
+    if (in_range(cp, 0x0531, 0x0556)) {
+        return cp + 0x30;
+    }
+    if (cp == 0x1E9E) {
+        return 0x00DF;
+    }
+    if (in_range(cp, 0x1E00, 0x1E95) || in_range(cp, 0x1EA0, 0x1EFF)) {
+        return fold_even_odd(cp);
+    }
+    if (in_range(cp, 0xFF21, 0xFF3A)) {
+        return cp + 0x20;
+    }
+    return cp;
+}
+
+std::string_view trim_word_utf8(std::string_view word) {
+    const char *begin = word.data();
+    const char *end = word.data() + word.size();
+    while (begin < end) {
+        char32_t cp;
+        size_t length = decode_utf8(begin, end, cp);
+        if (is_unicode_word_char(cp)) {
+            break;
+        }
+        begin += length;
+    }
+    while (end > begin) {
+        // najdeme začátek posledního znaku a ověříme, že je celý platný
+        const char *last = end - 1;
+        while (last > begin && end - last < 4 && is_continuation(*last)) {
+            --last;
+        }
+        char32_t cp;
+        size_t length = decode_utf8(last, end, cp);
+        if (last + length != end) {
+            last = end - 1;
+            cp = invalid_code_point;
+        }
+        if (is_unicode_word_char(cp)) {
+            break;
+        }
+        end = last;
+    }
+    return std::string_view(begin, static_cast<size_t>(end - begin));
+}
+
+std::string_view fold_word(std::string_view word, std::string &out) {
+    out.clear();
+    if (!has_high_bytes(word)) {
+        for (char c : word) {
+            out.push_back(in_range(static_cast<unsigned char>(c), 'A', 'Z') ? static_cast<char>(c + 0x20) : c);
+        }
+        return out;
+    }
+    const char *p = word.data();
+    const char *end = word.data() + word.size();
+    while (p < end) {
+        char32_t cp;
+        size_t length = decode_utf8(p, end, cp);
+        if (cp == invalid_code_point && length == 1) {
+            // neplatný bajt necháme, jak je
+            out.push_back(*p);
+        } else {
+            encode_utf8(fold_case(cp), out);
+        }
+        p += length;
+    }
+    return out;
+}
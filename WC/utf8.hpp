@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+//! Náhradní znak pro neplatné sekvence.
+static const char32_t invalid_code_point = 0xFFFD;
+
+/**
+ * Dekóduje jeden znak UTF-8 z [p, end), kód uloží do `cp`. Vrací počet
+ * přečtených bajtů. Neplatná nebo useknutá sekvence se čte jako jeden
+ * bajt s kódem invalid_code_point.
+ */
+size_t decode_utf8(const char *p, const char *end, char32_t &cp);
+
+//! Zapíše `cp` v UTF-8 na konec `out`.
+void encode_utf8(char32_t cp, std::string &out);
+
+/**
+ * Vrací true pro znaky, které patří do slova: písmena a číslice ASCII
+ * a všechny ostatní znaky kromě interpunkce, mezer a symbolů z běžných
+ * bloků (Latin-1, General Punctuation, šipky a matematické symboly,
+ * CJK interpunkce, fullwidth interpunkce, emoji...). Neplatné sekvence
+ * do slova nepatří.
+ */
+bool is_unicode_word_char(char32_t cp);
+
+/**
+ * Jednoduchý (1:1) case folding pro ASCII, Latin-1, Latin Extended-A,
+ * Latin Extended Additional, řečtinu, základní cyrilici, arménštinu
+ * a fullwidth latinku. Ostatní znaky vrací beze změny.
+ */
+char32_t fold_case(char32_t cp);
+
+//! Odřízne nealfanumerické znaky z obou konců slova, které obsahuje bajty >= 0x80.
+std::string_view trim_word_utf8(std::string_view word);
+
+//! Zapíše do `out` slovo `word` po case foldingu a vrátí pohled na `out`.
+std::string_view fold_word(std::string_view word, std::string &out);
@@ -0,0 +1,181 @@
+#include "word_table.hpp"
+
+#include <algorithm>
+
+namespace {
+    const size_t arena_block_size = 64 * 1024;
+
+    size_t round_up_pow2(size_t n) {
+        size_t ret = 16;
+        while (ret < n) {
+            ret <<= 1;
+        }
+        return ret;
+    }
+}
+
+word_table::word_table(size_t initial_capacity) {
+    m_slots.resize(round_up_pow2(initial_capacity));
+    m_mask = m_slots.size() - 1;
+}
+
+word_table::word_table(word_table &&other) : word_table() {
+    swap(other);
+}
+
+word_table &word_table::operator=(word_table &&other) {
+    word_table taken(std::move(other));
+    swap(taken);
+    return *this;
+}
+
+void word_table::add(std::string_view word, long count) {
+    if (!word.empty()) {
+        add(word, hash_word(word), count);
+    }
+}
+
+void word_table::add(std::string_view word, uint64_t hash, long count) {
+    // prázdné slovo by v aréně nic nezabralo a store mohl vrátit nullptr,
+    // takže by slot dál vypadal jako volný
+    if (word.empty()) {
+        return;
+    }
+    size_t i = hash & m_mask;
+    while (true) {
+        slot &s = m_slots[i];
+        if (!s.data) {
+            s.hash = hash;
+            s.data = store(word);
+            s.length = word.size();
+            s.count = count;
+            // udržujeme zaplnění nejvýše na 1/2
+            if (++m_size * 2 > m_slots.size()) {
+                grow();
+            }
+            return;
+        }
+        if (s.hash == hash && s.length == word.size() && std::memcmp(s.data, word.data(), s.length) == 0) {
+            s.count += count;
+            return;
+        }
+        i = (i + 1) & m_mask;
+    }
+}
+
+long word_table::count(std::string_view word) const {
+    if (word.empty()) {
+        return 0;
+    }
+    uint64_t hash = hash_word(word);
+    for (size_t i = hash & m_mask; m_slots[i].data; i = (i + 1) & m_mask) {
+        const slot &s = m_slots[i];
+        if (s.hash == hash && s.length == word.size() && std::memcmp(s.data, word.data(), s.length) == 0) {
+            return s.count;
+        }
+    }
+    return 0;
+}
+
+void word_table::merge(const word_table &other) {
+    for (const auto &s : other.m_slots) {
+        if (s.data) {
+            add(std::string_view(s.data, s.length), s.hash, s.count);
+        }
+    }
+}
+
+size_t word_table::size() const {
+    return m_size;
+}
+
+bool word_table::empty() const {
+    return m_size == 0;
+}
+
+size_t word_table::capacity() const {
+    return m_slots.size();
+}
+
+size_t word_table::arena_bytes() const {
+    return m_arena_bytes;
+}
+
+word_table::probe_stats word_table::probes() const {
+    probe_stats ret;
+    for (size_t i = 0; i < m_slots.size(); ++i) {
+        if (m_slots[i].data) {
+            size_t length = ((i - m_slots[i].hash) & m_mask) + 1;
+            ret.total += length;
+            ret.longest = std::max(ret.longest, length);
+        }
+    }
+    return ret;
+}
+
+void word_table::clear() {
+    std::fill(m_slots.begin(), m_slots.end(), slot());
+    m_size = 0;
+    m_blocks.clear();
+    m_block_pos = nullptr;
+    m_block_left = 0;
+    m_arena_bytes = 0;
+}
+
+void word_table::swap(word_table &other) noexcept {
+    m_slots.swap(other.m_slots);
+    std::swap(m_size, other.m_size);
+    std::swap(m_mask, other.m_mask);
+    m_blocks.swap(other.m_blocks);
+    std::swap(m_block_pos, other.m_block_pos);
+    std::swap(m_block_left, other.m_block_left);
+    std::swap(m_arena_bytes, other.m_arena_bytes);
+}
+
+std::vector<word_table::value_type> word_table::sorted() const {
+    std::vector<value_type> ret;
+    ret.reserve(m_size);
+    for_each([&ret](std::string_view word, long count) {
+        ret.emplace_back(word, count);
+    });
+    std::sort(ret.begin(), ret.end(), [](const value_type &lhs, const value_type &rhs) {
+        return lhs.first < rhs.first;
+    });
+    return ret;
+}
+
+const char *word_table::store(std::string_view word) {
+    if (word.size() > m_block_left) {
+        if (word.size() > arena_block_size / 4) {
+            // dlouhá slova dostanou vlastní blok, aby se nezahazoval zbytek aktuálního
+            m_blocks.emplace_back(new char[word.size()]);
+            m_arena_bytes += word.size();
+            std::memcpy(m_blocks.back().get(), word.data(), word.size());
+            return m_blocks.back().get();
+        }
+        m_blocks.emplace_back(new char[arena_block_size]);
+        m_block_pos = m_blocks.back().get();
+        m_block_left = arena_block_size;
+        m_arena_bytes += arena_block_size;
+    }
+    char *ret = m_block_pos;
+    std::memcpy(ret, word.data(), word.size());
+    m_block_pos += word.size();
+    m_block_left -= word.size();
+    return ret;
+}
+
+void word_table::grow() {
+    std::vector<slot> old(m_slots.size() * 2);
+    old.swap(m_slots);
+    m_mask = m_slots.size() - 1;
+    for (const auto &s : old) {
+        if (s.data) {
+            size_t i = s.hash & m_mask;
+            while (m_slots[i].data) {
+                i = (i + 1) & m_mask;
+            }
+            m_slots[i] = s;
+        }
+    }
+}
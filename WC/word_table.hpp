@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+//! Rychlý 64bitový hash slova (čte po 8 bajtech, na konci promíchá bity).
+inline uint64_t hash_word(std::string_view word) {
+    const uint64_t mul = 0x9E3779B97F4A7C15ull;
+    uint64_t h = word.size() * mul;
+    const char *p = word.data();
+    size_t n = word.size();
+    while (n >= 8) {
+        uint64_t block;
+        std::memcpy(&block, p, 8);
+        h = (h ^ block) * mul;
+        h ^= h >> 29;
+        p += 8;
+        n -= 8;
+    }
+    if (n > 0) {
+        uint64_t block = 0;
+        std::memcpy(&block, p, n);
+        h = (h ^ block) * mul;
+    }
+    h ^= h >> 32;
+    h *= 0xD6E8FEB86659FD93ull;
+    h ^= h >> 32;
+    return h;
+}
+
+/**
+ * Tabulka četností slov s otevřenou adresací (lineární sondování).
+ *
+ * Klíče jsou string_view do vlastní arény, takže vložení nového slova
+ * znamená jen zkopírování jeho bajtů na konec aktuálního bloku arény
+ * a vyhledání existujícího slova nealokuje nic. Tabulka neudržuje žádné
+ * pořadí, seřazený výpis vrací až sorted().
+ */
+class word_table {
+public:
+    using value_type = std::pair<std::string_view, long>;
+
+    struct probe_stats {
+        uint64_t total = 0; //!< součet délek sondování (prohlédnutých slotů) přes všechna slova
+        size_t longest = 0;
+    };
+
+    explicit word_table(size_t initial_capacity = 1024);
+
+    /**
+     * Přesun převezme sloty i arénu; `other` zůstane prázdná tabulka ve stejném
+     * stavu jako nově vytvořená, takže ji jde dál používat.
+     */
+    word_table(word_table &&other);
+
+    word_table &operator=(word_table &&other);
+
+    word_table(const word_table &) = delete;
+
+    word_table &operator=(const word_table &) = delete;
+
+    //! Přičte `count` výskytů slova `word`. Prázdná slova ignoruje.
+    void add(std::string_view word, long count = 1);
+
+    /**
+     * Přičte `count` výskytů slova s již spočítaným hashem `hash`. Hash
+     * nemusí být hash_word(word), ale pro stejné slovo musí být vždy stejný;
+     * tabulku s jiným hashem pak nejde dotazovat přes count(). Prázdná
+     * slova ignoruje.
+     */
+    void add(std::string_view word, uint64_t hash, long count);
+
+    //! Vrací počet výskytů slova, 0 pokud v tabulce není.
+    long count(std::string_view word) const;
+
+    //! Přičte všechna slova z `other`.
+    void merge(const word_table &other);
+
+    //! Počet různých slov.
+    size_t size() const;
+
+    bool empty() const;
+
+    //! Počet slotů; tabulka se zvětší, když by zaplnění překročilo polovinu.
+    size_t capacity() const;
+
+    //! Kolik bajtů zabírá aréna se slovy.
+    size_t arena_bytes() const;
+
+    //! Kolik slotů je potřeba prohlédnout, než se najde uložené slovo.
+    probe_stats probes() const;
+
+    //! Vyprázdní tabulku a uvolní arénu, pole slotů si ponechá.
+    void clear();
+
+    void swap(word_table &other) noexcept;
+
+    //! Všechna slova s četnostmi seřazená lexikograficky podle slova.
+    std::vector<value_type> sorted() const;
+
+    //! Zavolá `fn(word, count)` pro každé slovo v neurčeném pořadí.
+    template <typename Fn>
+    void for_each(Fn &&fn) const {
+        for (const auto &slot : m_slots) {
+            if (slot.data) {
+                fn(std::string_view(slot.data, slot.length), slot.count);
+            }
+        }
+    }
+
+private:
+    struct slot {
+        uint64_t hash = 0;
+        const char *data = nullptr;
+        size_t length = 0;
+        long count = 0;
+    };
+
+    const char *store(std::string_view word);
+
+    void grow();
+
+    std::vector<slot> m_slots;
+    size_t m_size = 0;
+    size_t m_mask = 0;
+
+    std::vector<std::unique_ptr<char[]>> m_blocks;
+    char *m_block_pos = nullptr;
+    size_t m_block_left = 0;
+    size_t m_arena_bytes = 0;
+};
@@ -0,0 +1,125 @@
+#include "work_pool.hpp"
+
+#include <algorithm>
+
+work_stealing_pool::work_stealing_pool(unsigned workers, feed source) : m_feed(std::move(source)) {
+    for (unsigned i = 0; i < std::max(1u, workers); ++i) {
+        m_queues.push_back(std::make_unique<queue>());
+    }
+}
+
+work_stealing_pool::~work_stealing_pool() {
+    wait();
+}
+
+size_t work_stealing_pool::size() const {
+    return m_queues.size();
+}
+
+void work_stealing_pool::push(size_t worker, task work) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_pending;
+    }
+    {
+        queue &q = *m_queues[worker % m_queues.size()];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        q.tasks.push_back(std::move(work));
+    }
+    notify();
+}
+
+void work_stealing_pool::start() {
+    for (size_t i = 0; i < m_queues.size(); ++i) {
+        m_threads.emplace_back(&work_stealing_pool::run, this, i);
+    }
+}
+
+void work_stealing_pool::wake() {
+    notify();
+}
+
+void work_stealing_pool::wait() {
+    for (auto &thread : m_threads) {
+        thread.join();
+    }
+    m_threads.clear();
+}
+
+void work_stealing_pool::notify() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_events;
+    }
+    m_changed.notify_all();
+}
+
+bool work_stealing_pool::take(size_t worker, task &work) {
+    {
+        queue &own = *m_queues[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            work = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    for (size_t i = 1; i < m_queues.size(); ++i) {
+        queue &other = *m_queues[(worker + i) % m_queues.size()];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if (!other.tasks.empty()) {
+            work = std::move(other.tasks.front());
+            other.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void work_stealing_pool::run(size_t worker) {
+    while (true) {
+        size_t seen;
+        bool feed_source;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            seen = m_events;
+            feed_source = !m_exhausted;
+        }
+        task work;
+        if (take(worker, work)) {
+            work(worker);
+            work = nullptr;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_pending;
+            ++m_events;
+            // poslední úloha může uvolnit ostatní k ukončení
+            if (m_pending == 0) {
+                m_changed.notify_all();
+            }
+            continue;
+        }
+        if (feed_source) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                ++m_pending;
+            }
+            feed_result result = m_feed(worker);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_pending;
+            if (result == feed_result::exhausted) {
+                m_exhausted = true;
+            }
+            if (result != feed_result::empty) {
+                ++m_events;
+                m_changed.notify_all();
+                continue;
+            }
+        }
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_exhausted && m_pending == 0) {
+            m_changed.notify_all();
+            return;
+        }
+        m_changed.wait(lock, [&]() { return m_events != seen || (m_exhausted && m_pending == 0); });
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Skupina vláken s vlastními frontami úloh a kradením práce.
+ *
+ * Každé vlákno bere úlohy z konce své fronty (naposledy přidané, data jsou
+ * ještě v cache) a když ji má prázdnou, krade ze začátku front ostatních.
+ * Úloha může přidávat další úlohy do fronty svého vlákna, takže velký soubor
+ * rozdělený na úseky si rozeberou všechna vlákna, která zrovna nemají co dělat.
+ *
+ * Když nemá vlákno co dělat ani co ukrást, zavolá zdroj práce `feed`
+ * (například další soubor ze seznamu). Skupina skončí, až zdroj vrátí
+ * `exhausted` a žádná úloha neběží ani nečeká.
+ */
+class work_stealing_pool {
+public:
+    //! Úloha dostane číslo vlákna, na kterém běží (0 .. size() - 1).
+    using task = std::function<void(size_t worker)>;
+
+    enum class feed_result {
+        worked,    //!< zdroj něco udělal nebo přidal úlohy
+        empty,     //!< zatím nic, má se zkusit znovu po wake()
+        exhausted, //!< zdroj už nic dalšího nedá
+    };
+
+    using feed = std::function<feed_result(size_t worker)>;
+
+    work_stealing_pool(unsigned workers, feed source);
+
+    //! Počká na dokončení, pokud už vlákna běží.
+    ~work_stealing_pool();
+
+    work_stealing_pool(const work_stealing_pool &) = delete;
+
+    work_stealing_pool &operator=(const work_stealing_pool &) = delete;
+
+    size_t size() const;
+
+    //! Přidá úlohu do fronty vlákna `worker`; smí se volat odkudkoli.
+    void push(size_t worker, task work);
+
+    //! Spustí vlákna.
+    void start();
+
+    //! Probudí nečinná vlákna, aby znovu zkusila zdroj práce.
+    void wake();
+
+    //! Počká, až skupina skončí.
+    void wait();
+
+private:
+    struct queue {
+        std::mutex mutex;
+        std::deque<task> tasks;
+    };
+
+    void run(size_t worker);
+
+    bool take(size_t worker, task &work);
+
+    //! Zvýší čítač událostí a probudí čekající vlákna.
+    void notify();
+
+    std::vector<std::unique_ptr<queue>> m_queues;
+    feed m_feed;
+
+    std::mutex m_mutex;
+    std::condition_variable m_changed;
+    //! Úlohy ve frontách + běžící úlohy + běžící volání zdroje.
+    size_t m_pending = 0;
+    size_t m_events = 0;
+    bool m_exhausted = false;
+
+    std::vector<std::thread> m_threads;
+};